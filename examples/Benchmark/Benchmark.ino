@@ -0,0 +1,415 @@
+/*
+ *  Project     Xbox 360 Controller LEDs Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/Xbox360ControllerLEDs
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *  Example:      Benchmark
+ *  Description:  Measure the per-call cost of the animation handler's main
+ *                functions and of the pin output. Results are printed to
+ *                the serial monitor at 115200 baud.
+ *
+ *                On AVR boards the timings are in CPU cycles, counted by
+ *                TIMER1 and its overflow interrupt, so batches longer than
+ *                the 16-bit counter are still timed correctly. Timer1 PWM
+ *                (pins 9 and 10 on the Uno) is unavailable while the
+ *                benchmark runs. On the host build the timings are
+ *                in time stamp counter ticks on x86 (or nanoseconds on other
+ *                hosts). Other boards fall back to micros().
+ *
+ *                Each handler test is run twice: once with the default
+ *                handler, which writes the LEDs through a virtual function,
+ *                and once with the static handler, which resolves the output
+ *                at compile time.
+ *
+ *                The linked pattern tests run in real time and take about
+ *                30 seconds to complete on hardware.
+ */
+
+#include <X360ControllerLEDs.h>
+
+#if defined(ARDUINO_HOST)
+#include <chrono>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#endif
+
+// Benchmark Options
+const uint16_t Iterations  = 1000;  // # of calls per averaged measurement
+const uint16_t BatchSize   = 100;   // # of calls per timer reading
+const uint8_t  LinkSamples = 5;     // # of linked pattern changes to time
+
+// Pins for the output tests
+const uint8_t Pin_Single = LED_BUILTIN;
+const uint8_t Pin1 = 2;
+const uint8_t Pin2 = 3;
+const uint8_t Pin3 = 4;
+const uint8_t Pin4 = 5;
+
+// --------------------------------------------------------
+// Timer                                                  |
+// --------------------------------------------------------
+
+#if defined(__AVR__)
+typedef uint32_t ticks_t;  // TIMER1 is a 16-bit counter, extended by counting its overflows
+const char TickUnit[] = "cycles";
+
+volatile uint16_t timerOverflows = 0;  // Upper 16 bits of the count
+
+ISR(TIMER1_OVF_vect) {
+	timerOverflows++;
+}
+
+void timerBegin() {
+	TCCR1A = 0;
+	TCCR1B = (1 << CS10);  // No prescaler, 1 tick = 1 CPU cycle
+	TCNT1 = 0;
+	TIFR1 = (1 << TOV1);   // Clear any pending overflow
+	TIMSK1 = (1 << TOIE1); // Overflow interrupt only, every 65536 cycles
+}
+
+inline ticks_t timerRead() {
+	const uint8_t sreg = SREG;
+	cli();
+	uint16_t high = timerOverflows;
+	const uint16_t low = TCNT1;
+	if ((TIFR1 & (1 << TOV1)) && low < 0x8000) high++;  // Wrapped, but the interrupt hasn't run yet
+	SREG = sreg;
+	return ((uint32_t) high << 16) | low;
+}
+
+uint32_t ticksToNs(uint32_t ticks) {
+	return ticks * 1000UL / (F_CPU / 1000000UL);
+}
+
+#elif defined(ARDUINO_HOST)
+typedef uint32_t ticks_t;
+
+#if defined(__x86_64__) || defined(__i386__)
+const char TickUnit[] = "tsc";  // Time stamp counter, calibrated against the system clock
+uint32_t tscPerUs = 1;
+
+void timerBegin() {
+	using namespace std::chrono;
+	const steady_clock::time_point t0 = steady_clock::now();
+	const uint64_t tsc0 = __rdtsc();
+	while (steady_clock::now() - t0 < milliseconds(20));
+	const uint64_t us = duration_cast<microseconds>(steady_clock::now() - t0).count();
+	tscPerUs = (uint32_t) ((__rdtsc() - tsc0) / us);
+	if (tscPerUs == 0) tscPerUs = 1;
+}
+
+inline ticks_t timerRead() {
+	return (ticks_t) __rdtsc();
+}
+
+uint32_t ticksToNs(uint32_t ticks) {
+	return (uint32_t) ((uint64_t) ticks * 1000 / tscPerUs);
+}
+#else
+const char TickUnit[] = "ns";
+
+void timerBegin() {}
+
+inline ticks_t timerRead() {
+	using namespace std::chrono;
+	return (ticks_t) duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+uint32_t ticksToNs(uint32_t ticks) {
+	return ticks;
+}
+#endif
+
+#else
+typedef uint32_t ticks_t;
+const char TickUnit[] = "us";
+
+void timerBegin() {}
+
+inline ticks_t timerRead() {
+	return micros();
+}
+
+uint32_t ticksToNs(uint32_t ticks) {
+	return ticks * 1000UL;
+}
+#endif
+
+ticks_t timerOverhead = 0;  // Cost of an empty measurement, subtracted from results
+
+inline uint32_t timerElapsed(ticks_t start) {
+	const ticks_t end = timerRead();
+	const ticks_t elapsed = (ticks_t) (end - start);
+	return elapsed > timerOverhead ? elapsed - timerOverhead : 0;
+}
+
+// Advances time on the host, where the clock is virtual. On hardware
+// time passes on its own.
+inline void waitTick() {
+#if defined(ARDUINO_HOST)
+	ArduinoHost::advanceMillis(1);
+#endif
+}
+
+// --------------------------------------------------------
+// Results                                                |
+// --------------------------------------------------------
+
+struct Result {
+	uint32_t total = 0;  // Sum of all timings, in ticks
+	uint32_t count = 0;  // # of operations timed
+	uint32_t min = 0xFFFFFFFF;  // Fastest single timing, in ticks
+
+	void add(uint32_t ticks, uint32_t n = 1) {
+		total += ticks;
+		count += n;
+		if (ticks / n < min) min = ticks / n;
+	}
+
+	uint32_t mean() const {
+		return count ? total / count : 0;
+	}
+};
+
+void printResult(const __FlashStringHelper * name, const Result & r) {
+	Serial.print(name);
+	Serial.print(F(": "));
+	if (r.count == 0) {
+		Serial.println(F("no samples"));
+		return;
+	}
+	Serial.print(r.mean());
+	Serial.print(' ');
+	Serial.print(TickUnit);
+	Serial.print(F(" mean, "));
+	Serial.print(r.min);
+	Serial.print(' ');
+	Serial.print(TickUnit);
+	Serial.print(F(" min ("));
+	Serial.print(ticksToNs(r.mean()));
+	Serial.print(F(" ns), n = "));
+	Serial.println(r.count);
+}
+
+// Times 'Iterations' calls of a function, in batches
+template<typename Function>
+Result timeBatches(Function fn) {
+	Result r;
+	for (uint16_t i = 0; i < Iterations / BatchSize; i++) {
+		const ticks_t start = timerRead();
+		for (uint16_t j = 0; j < BatchSize; j++) {
+			fn(j);
+		}
+		r.add(timerElapsed(start), BatchSize);
+	}
+	return r;
+}
+
+// --------------------------------------------------------
+// Outputs                                                |
+// --------------------------------------------------------
+
+// Output that discards the LED states, so the handler can be
+// timed without the cost of the pin writes
+class NullOutput : public XboxControllerLEDs_Custom<4> {
+public:
+	void begin() {
+		setPattern(XboxLEDPattern::Off);
+	}
+
+	unsigned long writes = 0;  // # of setLEDs calls
+
+protected:
+	void setLEDs(uint8_t ledStates) {
+		(void) ledStates;
+		writes++;
+	}
+};
+
+// Same as above, using the static (non-virtual) handler
+class StaticNullOutput : public XboxControllerLEDs_CustomStatic<StaticNullOutput, 4> {
+public:
+	void begin() {
+		setPattern(XboxLEDPattern::Off);
+	}
+
+	unsigned long writes = 0;  // # of setLEDs calls
+
+protected:
+	void setLEDs(uint8_t ledStates) {
+		(void) ledStates;
+		writes++;
+	}
+};
+
+// Pin outputs with the frame write made public, so it can be timed directly
+template<uint8_t... pins>
+class BenchPins : public XboxControllerLEDs<pins...> {
+public:
+	using XboxControllerLEDs<pins...>::setLEDs;
+};
+
+template<uint8_t... pins>
+class BenchStaticPins : public XboxControllerLEDs_Static<pins...> {
+public:
+	using XboxControllerLEDs_Static<pins...>::setLEDs;
+};
+
+template<uint8_t... pins>
+class BenchDirectPins : public XboxControllerLEDs_Direct<pins...> {
+public:
+	using XboxControllerLEDs_Direct<pins...>::setLEDs;
+};
+
+NullOutput leds;
+StaticNullOutput staticLeds;
+
+BenchPins<Pin_Single> pinsSingle;
+BenchPins<Pin1, Pin2, Pin3, Pin4> pinsQuad;
+BenchStaticPins<Pin_Single> staticPinsSingle;
+BenchStaticPins<Pin1, Pin2, Pin3, Pin4> staticPinsQuad;
+BenchDirectPins<Pin_Single> directPinsSingle;
+BenchDirectPins<Pin1, Pin2, Pin3, Pin4> directPinsQuad;
+
+// --------------------------------------------------------
+// Benchmarks                                             |
+// --------------------------------------------------------
+
+void benchMillis() {
+	volatile unsigned long sink;
+	printResult(F("millis()"), timeBatches([&](uint16_t) { sink = millis(); }));
+	(void) sink;
+}
+
+template<class Handler>
+void benchRunIdle(Handler & leds) {
+	leds.setPattern(XboxLEDPattern::Player1);  // Single frame, never advances
+	printResult(F("run() static pattern"), timeBatches([&](uint16_t) { leds.run(); }));
+
+	leds.setPattern(XboxLEDPattern::Blinking);  // 300 ms frames, won't advance during the test
+	printResult(F("run() idle"), timeBatches([&](uint16_t) { leds.run(); }));
+}
+
+template<class Handler>
+void benchSetPattern(Handler & leds) {
+	leds.setPattern(XboxLEDPattern::Off);
+	printResult(F("setPattern() change"), timeBatches([&](uint16_t i) {
+		leds.setPattern((i & 1) ? XboxLEDPattern::Off : XboxLEDPattern::Blinking);
+	}));
+	printResult(F("setPattern() same"), timeBatches([&](uint16_t) {
+		leds.setPattern(XboxLEDPattern::Blinking);
+	}));
+	printResult(F("linkPattern() same"), timeBatches([&](uint16_t) {
+		leds.linkPattern(XboxLEDPattern::Blinking);
+	}));
+}
+
+// Runs the 'Blinking' pattern, which loops 4 times before linking
+// to 'BlinkSlow', and times each run() call by what it did
+template<class Handler>
+void benchRunFrames(Handler & leds) {
+	Result idle, advance, wrap, link;
+
+	leds.setPattern(XboxLEDPattern::Off);
+	leds.linkPattern(XboxLEDPattern::Blinking);
+
+	uint8_t links = 0;
+	while (links < LinkSamples) {
+		const XboxLEDPattern pattern = leds.getPattern();
+		const unsigned long writes = leds.writes;
+
+		const ticks_t start = timerRead();
+		leds.run();
+		const uint32_t t = timerElapsed(start);
+
+		if (leds.getPattern() != pattern) {
+			link.add(t);  // Handed off to the linked pattern
+			links++;
+			leds.setPattern(XboxLEDPattern::Off);
+			leds.linkPattern(XboxLEDPattern::Blinking);
+		}
+		else if (leds.writes != writes) {
+			if (leds.getLastFrame() == 0) wrap.add(t);  // Back to the first ('off') frame
+			else advance.add(t);
+		}
+		else {
+			idle.add(t);
+		}
+		waitTick();
+	}
+
+	printResult(F("run() no frame due"), idle);
+	printResult(F("run() next frame"), advance);
+	printResult(F("run() cycle wrap"), wrap);
+	printResult(F("run() linked pattern"), link);
+}
+
+template<class Single, class Quad>
+void benchOutputs(Single & single, Quad & quad) {
+	single.begin();
+	printResult(F("setLEDs() 1 pin"), timeBatches([&](uint16_t i) {
+		single.setLEDs((i & 1) ? 0x00 : 0x0F);
+	}));
+
+	quad.begin();
+	printResult(F("setLEDs() 4 pins"), timeBatches([&](uint16_t i) {
+		quad.setLEDs((i & 1) ? 0x00 : 0x0F);
+	}));
+}
+
+template<class Handler>
+void benchHandler(Handler & leds) {
+	leds.begin();
+	benchRunIdle(leds);
+	benchSetPattern(leds);
+	benchRunFrames(leds);
+}
+
+void setup() {
+	Serial.begin(115200);
+	while (!Serial);  // Wait for connection on native USB boards
+
+	timerBegin();
+	const ticks_t start = timerRead();
+	timerOverhead = (ticks_t) (timerRead() - start);
+
+	Serial.println(F("Xbox 360 Controller LEDs Benchmark"));
+	benchMillis();
+
+	Serial.println(F("\n-- Handler (virtual output) --"));
+	benchHandler(leds);
+	benchOutputs(pinsSingle, pinsQuad);
+
+	Serial.println(F("\n-- Handler (static output) --"));
+	benchHandler(staticLeds);
+	benchOutputs(staticPinsSingle, staticPinsQuad);
+
+	Serial.println(F("\n-- Direct port output --"));
+	benchOutputs(directPinsSingle, directPinsQuad);
+
+	Serial.println(F("\nDone!"));
+}
+
+void loop() {
+	// Empty!
+}
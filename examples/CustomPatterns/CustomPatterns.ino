@@ -0,0 +1,94 @@
+/*
+ *  Project     Xbox 360 Controller LEDs Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/Xbox360ControllerLEDs
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *  Example:      CustomPatterns
+ *  Description:  Replace the built-in single-LED animations with your own,
+ *                written as sequences of frames that are checked and packed
+ *                into flash at compile time.
+ *
+ *                Durations must be multiples of 10 ms and at most 655350 ms
+ *                per hold, or the sketch won't compile. A hold of 0 ms
+ *                lasts forever.
+ */
+
+#include <X360ControllerLEDs.h>
+#include <X360LEDSequence.h>
+
+const uint8_t LED_Pin = LED_BUILTIN;  // Use the built-in LED
+
+const uint8_t On  = 1;
+const uint8_t Off = 0;
+
+// Building Blocks
+using Blink = XboxLEDSequence<XboxLEDHold<On, 250>, XboxLEDHold<Off, 250>>;
+using Flash = XboxLEDSequence<XboxLEDHold<On, 50>, XboxLEDHold<Off, 100>>;
+
+// Player 'n': flash 'n' times, then stay off for a second
+template<uint8_t n>
+using Player = XboxLEDAnimation<XboxLEDSequence<XboxLEDRepeat<n, Flash>, XboxLEDHold<Off, 1000>>>;
+
+// One animation for every pattern, in the same order as XboxLEDPattern
+using MyAnimations = XboxLEDAnimationSet<1,
+	XboxLEDAnimation<XboxLEDHold<Off, 0>>,  // Off
+	XboxLEDAnimation<Blink>,                // Blinking
+	XboxLEDAnimation<Flash, 10, XboxLEDPattern::Player1>,  // Flash 1 - 4, then Player 1 - 4
+	XboxLEDAnimation<Flash, 10, XboxLEDPattern::Player2>,
+	XboxLEDAnimation<Flash, 10, XboxLEDPattern::Player3>,
+	XboxLEDAnimation<Flash, 10, XboxLEDPattern::Player4>,
+	Player<1>,                              // Player 1 - 4
+	Player<2>,
+	Player<3>,
+	Player<4>,
+	XboxLEDAnimation<Blink>,                // Rotating
+	XboxLEDAnimation<Blink, 1, XboxLEDPattern::Previous>,  // BlinkOnce
+	XboxLEDAnimation<Blink, 8, XboxLEDPattern::Previous>,  // BlinkSlow
+	XboxLEDAnimation<Blink>                 // Alternating
+>;
+
+// Output Class
+class MyLEDs : public XboxControllerLEDs_Custom<1> {
+public:
+	MyLEDs() : XboxControllerLEDs_Custom<1>(&MyAnimations::Set) {}
+
+	void begin() {
+		pinMode(LED_Pin, OUTPUT);
+		setPattern(XboxLEDPattern::Off);
+	}
+
+protected:
+	void setLEDs(uint8_t ledStates) {
+		digitalWrite(LED_Pin, ledStates & 1);
+	}
+};
+
+MyLEDs leds;
+
+void setup() {
+	leds.begin();  // Initialize pins
+	leds.linkPattern(XboxLEDPattern::Flash3);  // Flash, then show the 'player 3' pattern
+}
+
+void loop() {
+	leds.run();  // Evaluate the pattern and set the LEDs
+}
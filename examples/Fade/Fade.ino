@@ -0,0 +1,45 @@
+/*
+ *  Project     Xbox 360 Controller LEDs Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/Xbox360ControllerLEDs
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *  Example:      Fade
+ *  Description:  Cross-fade between the frames of the 'rotating' animation
+ *                using PWM instead of switching the LEDs on and off.
+ *
+ *                Requires 4 LEDs connected to PWM capable pins.
+ */
+
+#include <X360ControllerLEDs.h>
+#include <X360LEDFade.h>
+
+XboxControllerLEDs_PWM<3, 5, 6, 9> leds;  // Declare 4-LED object on PWM pins
+
+void setup() {
+	leds.begin();  // Initialize pins
+	leds.setFade(100, XboxLEDEasing::Smooth);  // Fade over 100 ms, easing in and out
+	leds.setPattern(XboxLEDPattern::Rotating);  // Set the 'rotating' pattern
+}
+
+void loop() {
+	leds.run();  // Evaluate the pattern and update the fades
+}
@@ -0,0 +1,80 @@
+/*
+ *  Project     Xbox 360 Controller LEDs Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/Xbox360ControllerLEDs
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *  Example:      Footprint
+ *  Description:  Report the RAM used by one instance of each of the
+ *                library's output classes. The sizes are printed to the
+ *                serial monitor at 115200 baud.
+ *
+ *                The CI build also reads the compiled sketch's symbol
+ *                table to report each instance and the flash used by the
+ *                code for each output class, for every board it builds.
+ *                Each instance is named 'Footprint_...' so it's easy to
+ *                find in the symbol table.
+ */
+
+#include <X360ControllerLEDs.h>
+
+XboxControllerLEDs<2, 3, 4, 5> Footprint_Pins;             // Individual pins, virtual output
+XboxControllerLEDs_Static<6, 7, 8, 9> Footprint_Static;    // Individual pins, static output
+XboxControllerLEDs_Direct<10, 11, 12, 13> Footprint_Direct;  // Port registers, static output
+XboxControllerLEDs<14> Footprint_Single;                   // Single LED, virtual output
+
+#ifdef __AVR__
+static_assert(sizeof(Footprint_Pins) <= 20, "XboxControllerLEDs<4 pins> is over its RAM budget (20 bytes)");
+#endif
+
+void printSize(const __FlashStringHelper * name, size_t size) {
+	Serial.print(name);
+	Serial.print(F(": "));
+	Serial.print(size);
+	Serial.println(F(" bytes"));
+}
+
+void setup() {
+	Serial.begin(115200);
+
+	Footprint_Pins.begin();
+	Footprint_Static.begin();
+	Footprint_Direct.begin();
+	Footprint_Single.begin();
+
+	Footprint_Pins.setPattern(XboxLEDPattern::Rotating);
+	Footprint_Static.setPattern(XboxLEDPattern::Alternating);
+	Footprint_Direct.setPattern(XboxLEDPattern::Blinking);
+	Footprint_Single.setPattern(XboxLEDPattern::Player2);
+
+	Serial.println(F("RAM per instance"));
+	printSize(F("XboxControllerLEDs<4 pins>"), sizeof(Footprint_Pins));
+	printSize(F("XboxControllerLEDs_Static<4 pins>"), sizeof(Footprint_Static));
+	printSize(F("XboxControllerLEDs_Direct<4 pins>"), sizeof(Footprint_Direct));
+	printSize(F("XboxControllerLEDs<1 pin>"), sizeof(Footprint_Single));
+}
+
+void loop() {
+	Footprint_Pins.run();
+	Footprint_Static.run();
+	Footprint_Direct.run();
+	Footprint_Single.run();
+}
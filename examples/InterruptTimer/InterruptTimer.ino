@@ -25,55 +25,49 @@
  *  Example:      InterruptTimer
  *  Description:  Blink using the library's LED animations without having to
  *                repeatedly call 'run' in loop().
- *                
- *                Only tested with Uno / Nano. Other boards will have different
- *                registers for their interrupt timers; read their datasheets
- *                to learn more. Requires use of TIMER2.
+ *
+ *                The animations run from a hardware timer interrupt that is
+ *                set to fire when the next frame is due. Supported on the
+ *                Uno / Nano (TIMER2), Leonardo / Micro (TIMER3), and
+ *                Mega (TIMER5).
+ *
+ *                The loop reads a snapshot of the animation state, which
+ *                is safe while the interrupt is changing it, and prints the
+ *                LED state to the serial monitor (115200 baud) whenever it
+ *                changes.
  */
 
 #include <X360ControllerLEDs.h>
-
-#if !defined(__AVR_ATmega328P__) && !defined(__AVR_ATmega168__)
-#error Interrupt registers not defined! Please try setting board to either Uno or Nano.
-#endif
+#include <X360LEDBackground.h>
+#include <X360LEDSnapshot.h>
 
 const uint8_t LED_Pin = LED_BUILTIN;  // Use the built-in LED
 
-XboxControllerLEDs<LED_Pin> leds;  // Declare single-LED object
+XboxControllerLEDs_Background<XboxControllerLEDs_Snapshots<XboxControllerLEDs<LED_Pin>>> leds;  // Declare single-LED object
+XBOX_LED_BACKGROUND(leds);  // Run the LEDs from the timer interrupt
 
 void setup() {
+	Serial.begin(115200);
+
 	leds.begin();  // Initialize pins
 	leds.setPattern(XboxLEDPattern::Blinking);  // Set the 'blinking' pattern
 
-	setupTimer();  // Initialize TIMER2 interrupt
+	leds.beginBackground();  // Start the timer interrupt
 }
 
 void loop() {
-	// Empty!
-}
-
-/* Calculate clock value: 
- *     TimerGoal: value to trigger the timer, in ms
- *     CompareValue: comparison value for the TIMER to trigger at (0 - 255)
- *
- *         ((F_CPU / 1024) * TimerGoal) / 1000;
- *         ((Clock speed / prescaler) * goal value (ms)) / 1000 (ms to s)
- *
- * Will automatically adjust to the CPU clock until the 'goal' value is
- * unobtainable for the current prescaler value
- */
-
-constexpr uint8_t  TimerGoal = 10;  // ms
-constexpr uint16_t CompareValue = ((F_CPU / 1024) * TimerGoal) / 1000; 
-
-void setupTimer() {
-	static_assert(CompareValue <= 0xFF, "Timer is out of range! Lower the goal value");
-	TCCR2B |= 0x07;       // Set TIMER2 prescaler to 1024
-	OCR2A = CompareValue & 0xFF; // Set TIMER2 compare to fire at a count of 10 ms
-	TIMSK2 |= (1 << 1);   // Enable TIMER2 Compare A interrupt
-}
+	// Nothing to run here! Just watch the animation state.
+	static uint8_t lastLEDs = 0xFF;
 
-ISR(TIMER2_COMPA_vect) {
-	leds.run();  // Execute LED animations
-	TCNT2 = 0;  // Reset timer counter
+	const XboxLEDSnapshot<> state = leds.getSnapshot();  // Pattern, frame, and LEDs, all from the same moment
+	if (state.leds != lastLEDs) {
+		Serial.print(F("Frame "));
+		Serial.print(state.frameIndex);
+		Serial.print(F(": LED "));
+		Serial.print(state.leds ? F("on") : F("off"));
+		Serial.print(F(", next change in "));
+		Serial.print(state.timeToNextFrame(millis()));
+		Serial.println(F(" ms"));
+		lastLEDs = state.leds;
+	}
 }
@@ -0,0 +1,74 @@
+/*
+ *  Project     Xbox 360 Controller LEDs Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/Xbox360ControllerLEDs
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *  Example:      Multiple
+ *  Description:  Run the LED animations for several controllers at once
+ *                using the multi-controller manager. Each 'controller' here
+ *                is a single LED, but the output class can write the LED
+ *                states anywhere (shift registers, addressable LEDs, etc.).
+ */
+
+#include <X360ControllerLEDs.h>
+#include <X360LEDManager.h>
+
+const uint8_t NumControllers = 4;
+const uint8_t Pins[NumControllers] = { 2, 3, 4, 5 };  // One LED per controller
+
+// Output Class
+class MultiPinOutput 
+	: public XboxControllerLEDs_Manager<MultiPinOutput, 1, NumControllers>  // 1 LED animations, 4 controllers
+{
+public:
+	void begin() {
+		for (uint8_t i = 0; i < NumControllers; i++) {
+			pinMode(Pins[i], OUTPUT);
+			setPattern(i, XboxLEDPattern::Off);
+		}
+	}
+
+protected:
+	/*  protected void setLEDs(uint8, uint8)
+	 *  Required function to send the LED state of one controller to its
+	 *  LEDs. Called whenever that controller's frame changes.
+	 */
+	void setLEDs(uint8_t controller, uint8_t ledStates) {
+		digitalWrite(Pins[controller], ledStates & 1);
+	}
+};
+
+MultiPinOutput leds;
+
+void setup() {
+	leds.begin();
+
+	// Each controller has a different player number
+	leds.linkPattern(0, XboxLEDPattern::Flash1);
+	leds.linkPattern(1, XboxLEDPattern::Flash2);
+	leds.linkPattern(2, XboxLEDPattern::Flash3);
+	leds.linkPattern(3, XboxLEDPattern::Flash4);
+}
+
+void loop() {
+	leds.run();  // Evaluate the patterns for all controllers that are due
+}
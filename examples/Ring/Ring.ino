@@ -0,0 +1,90 @@
+/*
+ *  Project     Xbox 360 Controller LEDs Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/Xbox360ControllerLEDs
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *  Example:      Ring
+ *  Description:  Run the controller animations on a ring of 8 LEDs, using
+ *                the wide animations that scale the 4 LED patterns to any
+ *                number of LEDs. Each player's quadrant lights a quarter of
+ *                the ring, and the 'rotating' pattern chases a single LED
+ *                around it.
+ *
+ *                Connect the LEDs to pins 2 - 9 in order, clockwise from
+ *                the first LED of the player 1 quadrant (top left).
+ */
+
+#include <X360ControllerLEDs.h>
+#include <X360LEDWide.h>
+
+const uint8_t NumLEDs = 8;
+const uint8_t Pins[NumLEDs] = { 2, 3, 4, 5, 6, 7, 8, 9 };
+
+// Output Class
+class RingOutput : public XboxControllerLEDs_Wide<RingOutput, NumLEDs> {
+public:
+	void begin() {
+		for (uint8_t i = 0; i < NumLEDs; i++) {
+			pinMode(Pins[i], OUTPUT);
+		}
+		setPattern(XboxLEDPattern::Off);
+	}
+
+protected:
+	void setLEDs(Word ledStates) {
+		updateLEDs(ledStates, AnimationSet::AllLEDs);
+	}
+
+	void updateLEDs(Word ledStates, Word changed) {  // Only write the LEDs that changed
+		for (uint8_t i = 0; i < NumLEDs; i++) {
+			if (changed & ((Word) 1 << i)) digitalWrite(Pins[i], (ledStates >> i) & 1);
+		}
+	}
+};
+
+RingOutput ring;
+
+const XboxLEDPattern Patterns[] = {
+	XboxLEDPattern::Flash1,       // Flash player 1, then stay on
+	XboxLEDPattern::Rotating,     // Chase around the ring, then back to player 1
+	XboxLEDPattern::Alternating,  // Alternate, then back to player 1
+	XboxLEDPattern::Flash3,       // Flash player 3, then stay on
+};
+const uint8_t NumPatterns = sizeof(Patterns) / sizeof(Patterns[0]);
+
+void setup() {
+	ring.begin();
+	ring.linkPattern(Patterns[0]);
+}
+
+void loop() {
+	static uint8_t current = 1;
+	static unsigned long lastChange = millis();
+
+	if (millis() - lastChange >= 8000) {  // New pattern every 8 seconds
+		ring.linkPattern(Patterns[current]);
+		current = (current + 1) % NumPatterns;
+		lastChange = millis();
+	}
+
+	ring.run();
+}
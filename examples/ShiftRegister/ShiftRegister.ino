@@ -0,0 +1,55 @@
+/*
+ *  Project     Xbox 360 Controller LEDs Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/Xbox360ControllerLEDs
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *  Example:      ShiftRegister
+ *  Description:  Run the 4-LED animations for 8 controllers on a chain of
+ *                four 74HC595 shift registers. Every controller's LEDs are
+ *                sent together in one SPI transfer per update.
+ *
+ *                Wiring: MOSI (pin 11 on the Uno) to the first register's
+ *                data input (DS), SCK (pin 13) to every SH_CP, and the
+ *                latch pin below to every ST_CP. Each register drives the
+ *                LEDs for two controllers: Q0-Q3 and Q4-Q7.
+ */
+
+#include <X360ControllerLEDs.h>
+#include <X360LEDShiftRegister.h>
+
+const uint8_t NumControllers = 8;
+const uint8_t LatchPin = 10;
+
+XboxControllerLEDs_ShiftRegisters<4, NumControllers, LatchPin> leds;  // 4 LEDs per controller
+
+void setup() {
+	leds.begin();  // Initialize SPI and turn off all LEDs
+
+	// Assign player numbers as if every controller just connected
+	for (uint8_t i = 0; i < NumControllers; i++) {
+		leds.linkPattern(i, (XboxLEDPattern) ((uint8_t) XboxLEDPattern::Flash1 + (i % 4)));
+	}
+}
+
+void loop() {
+	leds.run();  // Evaluate the patterns and send any changes to the registers
+}
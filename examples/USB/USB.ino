@@ -26,6 +26,11 @@
  *  Description:  Simple example for driving the Xbox LED animations from USB
  *                XInput control packets
  *
+ *                Received patterns are queued from the USB callback and
+ *                applied in order on the next call to 'run', so packets that
+ *                arrive back-to-back (e.g. 'Flash1' then 'Player1') are not
+ *                lost.
+ *
  *                Requires the Arduino XInput library and a compatible XInput
  *                boards package:
  *                https://www.github.com/dmadison/ArduinoXInput
@@ -33,6 +38,7 @@
  */
 
 #include <X360ControllerLEDs.h>
+#include <X360LEDQueue.h>
 #include <XInput.h>  // Arduino XInput library
 
 // Pin Definitions
@@ -43,10 +49,8 @@ const uint8_t LED_Pin_4 = 5;
 const boolean InvertOutput = false;   // LED output is normal (high = LED on)
                                       //   Set to "true" if sinking current.
 
-// Controller LED Object
-XboxControllerLEDs<LED_Pin_1, LED_Pin_2, LED_Pin_3, LED_Pin_4> leds(InvertOutput);  // Declare four-LED object
-
-boolean newPattern = false;  // flag for received data
+// Controller LED Object, with a queue for patterns received over USB
+XboxControllerLEDs_Queued<XboxControllerLEDs<LED_Pin_1, LED_Pin_2, LED_Pin_3, LED_Pin_4>> leds(InvertOutput);  // Declare four-LED object
 
 void setup() {
 	leds.begin();  // Initialize pins
@@ -56,16 +60,11 @@ void setup() {
 }
 
 void loop() {
-	if (newPattern == true) {  // if there's a new LED packet...
-		newPattern = false;  // disable flag
-		leds.linkPattern((XboxLEDPattern) XInput.getLEDPattern());   // Set pattern and use linked pattern features
-	}
-	
-	leds.run();
+	leds.run();  // Apply any received patterns, then evaluate the pattern and set the LEDs
 }
 
 void ledCallback(uint8_t message_type) {
 	if (message_type == (uint8_t) XInputReceiveType::LEDs) {
-		newPattern = true;  // new LED packet!
+		leds.queueLinkPattern((XboxLEDPattern) XInput.getLEDPattern());   // Queue pattern and use linked pattern features
 	}
 }
@@ -55,14 +55,30 @@ public:
 
 protected:
 	/*  protected void setLEDs(uint8)
-	 *  Required function to send the LED state to the LEDs. Called on every
-	 *  frame update.
+	 *  Required function to send the LED state to the LEDs. Called when
+	 *  the LEDs change.
 	 *  
 	 *  uint8_t argument is a packed byte that contains the on/off states
 	 *  for every LED in the current frame.
+	 *
+	 *  Not called by the handler here, because updateLEDs (below) is
+	 *  defined instead.
 	 */ 
 	void setLEDs(uint8_t ledStates) {
+		updateLEDs(ledStates, 0xFF);  // Every LED
+	}
+
+	/*  protected void updateLEDs(uint8, uint8)
+	 *  Optional function, called in place of setLEDs whenever the LEDs
+	 *  change. The second argument has a bit set for every LED that
+	 *  differs from the last update.
+	 *
+	 *  Sending data to the strip takes a while, so only the changed LEDs
+	 *  are recolored and frames that don't change any LEDs are never sent.
+	 */
+	void updateLEDs(uint8_t ledStates, uint8_t changed) {
 		for (uint8_t i = 0; i < NumLEDs; i++) {
+			if (!(changed & (1 << i))) continue;  // Same as before, skip
 			boolean thisLED = ledStates & (1 << i);  // Get extracted LED state
 
 			if (thisLED == HIGH) {
@@ -0,0 +1,83 @@
+/*
+ *  Project     Xbox 360 Controller LEDs Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/Xbox360ControllerLEDs
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *  Example:      UserPatterns
+ *  Description:  Load extra animations at runtime and play them alongside
+ *                the built-in patterns.
+ *
+ *                The animations here come from an array, but the same data
+ *                could be stored in EEPROM (see XboxLEDEEPROMReader) or
+ *                received over serial.
+ */
+
+#include <X360ControllerLEDs.h>
+#include <X360LEDRegistry.h>
+
+XboxControllerLEDs<2, 3, 4, 5> leds;  // Declare 4-LED object
+XboxLEDRegistry<4, 16> userAnimations;  // Room for 4 animations with 16 frames total
+
+const uint8_t AnimationData[] = {
+	'X', 2,  // Header, 2 animations
+
+	// Animation 0: 'bounce' the lit LED back and forth 5 times, then go back
+	6, 5, (uint8_t) XboxLEDPattern::Previous,  // 6 frames, 5 cycles, next pattern
+	0b0001, 8,  // LED states, duration in 10 ms ticks
+	0b0010, 8,
+	0b0100, 8,
+	0b1000, 8,
+	0b0100, 8,
+	0b0010, 8,
+
+	// Animation 1: 'heartbeat' forever
+	4, 0, (uint8_t) XboxLEDPattern::Null,
+	0b1111, 10,
+	0b0000, 10,
+	0b1111, 10,
+	0b0000, 70,
+
+	0xB3,  // Checksum, so that all bytes add up to 0
+};
+
+const XboxLEDPattern Bounce    = XboxLEDUserPattern(0);
+const XboxLEDPattern Heartbeat = XboxLEDUserPattern(1);
+
+void setup() {
+	leds.begin();  // Initialize pins
+
+	if (userAnimations.load(AnimationData, sizeof(AnimationData)) == XboxLEDLoadResult::Ok) {
+		leds.setUserAnimations(&userAnimations);
+	}
+
+	leds.setPattern(Heartbeat);  // Start with the 'heartbeat'
+}
+
+void loop() {
+	static unsigned long lastBounce = 0;
+	if (millis() - lastBounce >= 10000) {  // Bounce every 10 seconds, then back to the heartbeat
+		leds.linkPattern(Bounce);
+		lastBounce = millis();
+	}
+
+	leds.run();  // Evaluate the pattern and set the LEDs
+}
@@ -0,0 +1,205 @@
+/*
+ *  Project     Xbox 360 Controller LEDs Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/Xbox360ControllerLEDs
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include "Arduino.h"
+
+#include <stdio.h>
+
+namespace {
+	unsigned long long clock_us = 0;
+
+	uint8_t pinModes[ArduinoHost::NumPins];
+	unsigned long pinWrites[ArduinoHost::NumPins];
+	uint8_t pinLevels[ArduinoHost::NumPins];  // Last analogWrite value
+
+	boolean tracePins = false;
+}
+
+// Both clocks are 32-bit and roll over, as on the boards
+unsigned long millis() {
+	return (uint32_t) (clock_us / 1000);
+}
+
+unsigned long micros() {
+	return (uint32_t) clock_us;
+}
+
+void delay(unsigned long ms) {
+	ArduinoHost::advanceMillis(ms);
+}
+
+void delayMicroseconds(unsigned int us) {
+	ArduinoHost::advanceMicros(us);
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+	if (pin >= ArduinoHost::NumPins) return;
+	pinModes[pin] = mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+	if (pin >= ArduinoHost::NumPins) return;
+	val = (val != LOW);
+	pinWrites[pin]++;
+	if (tracePins && digitalRead(pin) != val) {
+		printf("%lu,%u,%u\n", millis(), pin, val);
+	}
+
+	volatile uint8_t * reg = portOutputRegister(digitalPinToPort(pin));
+	if (val) *reg |= digitalPinToBitMask(pin);
+	else *reg &= ~digitalPinToBitMask(pin);
+}
+
+void analogWrite(uint8_t pin, int val) {
+	if (pin >= ArduinoHost::NumPins) return;
+	if (val < 0) val = 0;
+	if (val > 255) val = 255;
+	if (tracePins && pinLevels[pin] != val) {
+		printf("%lu,%u,%d\n", millis(), pin, val);
+	}
+	pinLevels[pin] = (uint8_t) val;
+
+	// Pin reads high for at least half of the PWM period
+	volatile uint8_t * reg = portOutputRegister(digitalPinToPort(pin));
+	if (val >= 128) *reg |= digitalPinToBitMask(pin);
+	else *reg &= ~digitalPinToBitMask(pin);
+}
+
+int digitalRead(uint8_t pin) {
+	if (pin >= ArduinoHost::NumPins) return LOW;
+	return (*portOutputRegister(digitalPinToPort(pin)) & digitalPinToBitMask(pin)) ? HIGH : LOW;
+}
+
+void shiftOut(uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder, uint8_t val) {
+	for (uint8_t i = 0; i < 8; i++) {
+		if (bitOrder == LSBFIRST) digitalWrite(dataPin, val & (1 << i));
+		else digitalWrite(dataPin, val & (1 << (7 - i)));
+		digitalWrite(clockPin, HIGH);
+		digitalWrite(clockPin, LOW);
+	}
+}
+
+void noInterrupts() {}
+void interrupts() {}
+
+HostSerial Serial;
+
+void HostSerial::begin(unsigned long) {}
+
+size_t HostSerial::print(const __FlashStringHelper * str) {
+	return print(reinterpret_cast<const char *>(str));
+}
+
+size_t HostSerial::print(const char * str) {
+	return fputs(str, stdout) >= 0 ? strlen(str) : 0;
+}
+
+size_t HostSerial::print(char c) {
+	return putchar(c) != EOF ? 1 : 0;
+}
+
+size_t HostSerial::print(unsigned long n, int base) {
+	char buf[8 * sizeof(n) + 1];
+	char * str = &buf[sizeof(buf) - 1];
+	*str = '\0';
+
+	if (base < 2) base = DEC;
+	do {
+		const char c = n % base;
+		n /= base;
+		*--str = c < 10 ? c + '0' : c + 'A' - 10;
+	} while (n);
+
+	return print(str);
+}
+
+size_t HostSerial::print(long n, int base) {
+	if (base == DEC && n < 0) {
+		return print('-') + print((unsigned long) -n, base);
+	}
+	return print((unsigned long) n, base);
+}
+
+size_t HostSerial::print(double n, int digits) {
+	return printf("%.*f", digits, n);
+}
+
+size_t HostSerial::println() {
+	return print('\n');
+}
+
+namespace ArduinoHost {
+
+volatile uint8_t PortRegisters[NumPorts];
+
+void reset() {
+	clock_us = 0;
+	memset(pinModes, INPUT, sizeof(pinModes));
+	for (uint8_t i = 0; i < NumPorts; i++) PortRegisters[i] = 0x00;
+	memset(pinWrites, 0, sizeof(pinWrites));
+	memset(pinLevels, 0, sizeof(pinLevels));
+}
+
+void setMillis(unsigned long ms) {
+	clock_us = (unsigned long long) ms * 1000;
+}
+
+void setMicros(unsigned long long us) {
+	clock_us = us;
+}
+
+void advanceMillis(unsigned long ms) {
+	clock_us += (unsigned long long) ms * 1000;
+}
+
+void advanceMicros(unsigned long long us) {
+	clock_us += us;
+}
+
+unsigned long long getMicros() {
+	return clock_us;
+}
+
+uint8_t getPinMode(uint8_t pin) {
+	if (pin >= NumPins) return INPUT;
+	return pinModes[pin];
+}
+
+unsigned long getWriteCount(uint8_t pin) {
+	if (pin >= NumPins) return 0;
+	return pinWrites[pin];
+}
+
+uint8_t getAnalogLevel(uint8_t pin) {
+	if (pin >= NumPins) return 0;
+	return pinLevels[pin];
+}
+
+void setTrace(boolean enable) {
+	tracePins = enable;
+}
+
+}  // End namespace
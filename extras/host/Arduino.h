@@ -0,0 +1,159 @@
+/*
+ *  Project     Xbox 360 Controller LEDs Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/Xbox360ControllerLEDs
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *  Description:  Minimal Arduino core for building the library on a desktop
+ *                host. Time is provided by a virtual clock that only moves
+ *                when the caller advances it, so animations can be stepped
+ *                deterministically one tick at a time.
+ */
+
+#ifndef ArduinoHost_h
+#define ArduinoHost_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#define ARDUINO_HOST 1
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT        0x0
+#define OUTPUT       0x1
+#define INPUT_PULLUP 0x2
+
+#ifndef LED_BUILTIN
+#define LED_BUILTIN 13
+#endif
+
+#define LSBFIRST 0
+#define MSBFIRST 1
+
+#define DEC 10
+#define HEX 16
+#define BIN 2
+
+#ifndef F_CPU
+#define F_CPU 16000000UL
+#endif
+
+// Program memory is ordinary memory on the host
+#define PROGMEM
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#define pgm_read_word(addr) (*(const uint16_t *)(addr))
+#define pgm_read_ptr(addr) (*(const void * const *)(addr))
+#define memcpy_P(dest, src, n) memcpy((dest), (src), (n))
+
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper *>(string_literal))
+
+// --------------------------------------------------------
+// Arduino API                                            |
+// --------------------------------------------------------
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int  digitalRead(uint8_t pin);
+void analogWrite(uint8_t pin, int val);
+void shiftOut(uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder, uint8_t val);
+
+// Pins are grouped into 8-bit ports like on AVR: pin n is bit (n % 8)
+// of port (n / 8) + 1. Port 0 is not a port.
+#define NOT_A_PORT 0
+#define digitalPinToPort(pin)    ((uint8_t) ((pin) / 8 + 1))
+#define digitalPinToBitMask(pin) ((uint8_t) (1 << ((pin) % 8)))
+#define portOutputRegister(port) (&ArduinoHost::PortRegisters[(port) - 1])
+
+void noInterrupts();
+void interrupts();
+
+// --------------------------------------------------------
+// Serial                                                 |
+//     Writes to stdout                                   |
+// --------------------------------------------------------
+
+class HostSerial {
+public:
+	void begin(unsigned long baud);
+	operator bool() const { return true; }
+
+	size_t print(const __FlashStringHelper * str);
+	size_t print(const char * str);
+	size_t print(char c);
+	size_t print(unsigned long n, int base = DEC);
+	size_t print(long n, int base = DEC);
+	size_t print(unsigned int n, int base = DEC) { return print((unsigned long) n, base); }
+	size_t print(int n, int base = DEC) { return print((long) n, base); }
+	size_t print(double n, int digits = 2);
+
+	size_t println();
+	template<typename T> size_t println(T val) { size_t n = print(val); return n + println(); }
+	template<typename T> size_t println(T val, int fmt) { size_t n = print(val, fmt); return n + println(); }
+};
+
+extern HostSerial Serial;
+
+// --------------------------------------------------------
+// Host Controls                                          |
+//     Not part of the Arduino API. Used by host programs |
+//     to drive the virtual clock and inspect the pins.   |
+// --------------------------------------------------------
+
+namespace ArduinoHost {
+	static const uint8_t NumPins = 64;
+	static const uint8_t NumPorts = NumPins / 8;
+
+	extern volatile uint8_t PortRegisters[NumPorts];  // Pin output states
+
+	void reset();  // Zero the clock and all pin states
+
+	// Virtual clock. It counts in 64 bits, but millis() and micros()
+	// are truncated to 32 bits and roll over like they do on the boards.
+	void setMillis(unsigned long ms);
+	void setMicros(unsigned long long us);
+	void advanceMillis(unsigned long ms);
+	void advanceMicros(unsigned long long us);
+	unsigned long long getMicros();
+
+	// Pin inspection
+	uint8_t getPinMode(uint8_t pin);
+	unsigned long getWriteCount(uint8_t pin);  // # of digitalWrite calls (not direct port writes)
+	uint8_t getAnalogLevel(uint8_t pin);  // Last analogWrite value
+	void setTrace(boolean enable);  // Print pin changes to stdout
+}
+
+// Sketch entry points, used by the host main()
+void setup();
+void loop();
+
+#endif
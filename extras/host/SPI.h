@@ -0,0 +1,71 @@
+/*
+ *  Project     Xbox 360 Controller LEDs Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/Xbox360ControllerLEDs
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *  Description:  Minimal SPI library for the host build. Transfers are
+ *                counted and the most recent bytes are kept so host
+ *                programs can check what was sent.
+ */
+
+#ifndef SPIHost_h
+#define SPIHost_h
+
+#include "Arduino.h"
+
+#define SPI_MODE0 0x00
+#define SPI_MODE1 0x04
+#define SPI_MODE2 0x08
+#define SPI_MODE3 0x0C
+
+class SPISettings {
+public:
+	SPISettings() {}
+	SPISettings(uint32_t clock, uint8_t bitOrder, uint8_t dataMode) {
+		(void) clock; (void) bitOrder; (void) dataMode;
+	}
+};
+
+class SPIClass {
+public:
+	static const uint8_t LogSize = 64;
+
+	void begin() {}
+	void end() {}
+
+	void beginTransaction(SPISettings) { transactions++; }
+	void endTransaction() {}
+
+	uint8_t transfer(uint8_t data) {
+		log[bytes % LogSize] = data;
+		bytes++;
+		return 0x00;
+	}
+
+	unsigned long transactions = 0;  // # of beginTransaction calls
+	unsigned long bytes = 0;  // # of bytes transferred
+	uint8_t log[LogSize];  // Last bytes transferred, as a ring buffer
+};
+
+extern SPIClass SPI;
+
+#endif
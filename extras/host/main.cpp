@@ -0,0 +1,55 @@
+/*
+ *  Project     Xbox 360 Controller LEDs Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/Xbox360ControllerLEDs
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *  Description:  Host entry point for Arduino sketches. Runs setup() once,
+ *                then calls loop() once per virtual millisecond.
+ *
+ *                Usage: <sketch> [milliseconds] [-t]
+ *                    milliseconds  simulated run time (default 0)
+ *                    -t            print pin changes as "ms,pin,state"
+ */
+
+#include "Arduino.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+int main(int argc, char * argv[]) {
+	unsigned long runTime = 0;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-t") == 0) ArduinoHost::setTrace(true);
+		else runTime = strtoul(argv[i], NULL, 10);
+	}
+
+	ArduinoHost::reset();
+	setup();
+
+	const unsigned long long end = ArduinoHost::getMicros() + runTime * 1000ULL;
+	while (ArduinoHost::getMicros() < end) {
+		loop();
+		ArduinoHost::advanceMillis(1);
+	}
+	return 0;
+}
@@ -0,0 +1,125 @@
+/*
+ *  Project     Xbox 360 Controller LEDs Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/Xbox360ControllerLEDs
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *  Description:  Runs the background handler against a stand-in for the
+ *                Uno's 8-bit TIMER2, firing the compare interrupt after
+ *                OCR2A + 1 ticks of 64 us. Checks that waits longer than
+ *                the timer can count are split into several compares, that
+ *                only the last one runs the animation, and that each frame
+ *                starts on time (never early, at most two ticks late).
+ */
+
+#include "Arduino.h"
+
+// TIMER2 registers and bits, as on the ATmega328P
+volatile uint8_t TCCR2A, TCCR2B, TIMSK2, TCNT2, OCR2A;
+#define WGM21  1
+#define CS22   2
+#define CS21   1
+#define CS20   0
+#define OCIE2A 1
+
+#define __AVR_ATmega328P__
+#define ISR(vector) void vector()
+
+#include "X360ControllerLEDs.h"
+#include "X360LEDBackground.h"
+
+#include "Test.h"
+
+namespace {
+
+const unsigned long TickTime = 64;  // us per timer tick, /1024 at 16 MHz
+
+// Counts the animation passes run by the interrupt
+class Counted : public XboxControllerLEDs_Static<2, 3, 4, 5> {
+public:
+	unsigned long runs = 0;
+
+	void run(unsigned long now) {
+		runs++;
+		XboxControllerLEDs_Static<2, 3, 4, 5>::run(now);
+	}
+};
+
+XboxControllerLEDs_Background<Counted> leds;
+
+}  // End namespace
+
+XBOX_LED_BACKGROUND(leds)
+
+namespace {
+
+boolean timerEnabled() {
+	return TIMSK2 & (1 << OCIE2A);
+}
+
+// Fires the interrupts until 'end', checking each frame change against its deadline
+void runFor(unsigned long long end, unsigned long & frames, unsigned long & interrupts) {
+	while (timerEnabled()) {
+		const unsigned long long fire = ArduinoHost::getMicros() + (OCR2A + 1UL) * TickTime;
+		if (fire >= end) break;
+
+		const boolean animating = leds.isAnimating();
+		const unsigned long deadline = leds.nextDeadline();
+		const uint8_t frameIndex = leds.getFrameIndex();
+		ArduinoHost::setMicros(fire);
+		TIMER2_COMPA_vect();
+		interrupts++;
+
+		if (!animating) continue;  // Picking up a new pattern
+		if (leds.getFrameIndex() != frameIndex) {
+			frames++;
+			const unsigned long late = micros() - deadline;
+			CHECK(late < 2 * TickTime);
+		}
+		else CHECK(!Xbox360Controller_LEDs::XboxLEDHandlerCore::reached(micros(), deadline));  // Only counting down
+	}
+	ArduinoHost::setMicros(end);
+}
+
+}  // End namespace
+
+int main() {
+	ArduinoHost::reset();
+	leds.begin();
+	leds.setTiming(XboxLEDTiming::Skip, true);
+	leds.beginBackground();
+
+	unsigned long frames = 0, interrupts = 0;
+	runFor(1000, frames, interrupts);  // Picks up the first pattern
+
+	leds.setPattern(XboxLEDPattern::Rotating);  // 100 ms frames, about 7 compares each
+	runFor(2050000, frames, interrupts);
+	CHECK(frames == 20);
+	CHECK(interrupts > 6 * frames);
+	CHECK(leds.runs == frames + 2);  // One per frame, plus the pattern changes
+
+	leds.setPattern(XboxLEDPattern::Player1);  // Solid, the timer stops
+	runFor(3000000, frames, interrupts);
+	CHECK(!timerEnabled());
+	CHECK(leds.getLastFrame() == 0b0001);
+
+	return HostTest::finish("Background");
+}
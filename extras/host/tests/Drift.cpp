@@ -0,0 +1,115 @@
+/*
+ *  Project     Xbox 360 Controller LEDs Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/Xbox360ControllerLEDs
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *  Description:  Checks that the deadline timing policies don't drift. The
+ *                rotating pattern runs for 10,000 frames while the handler
+ *                is serviced with random 0.2 - 3.2 ms gaps, and every frame
+ *                must start on its own deadline (start + n x frame length),
+ *                in both the millis and micros timebases. The default
+ *                'Serviced' timing, which does add up lateness, is checked
+ *                to drift so the test can tell the difference.
+ */
+
+#include "X360ControllerLEDs.h"
+
+#include "Test.h"
+
+#include <vector>
+
+namespace {
+
+const unsigned long NumFrames = 10000;
+const unsigned long FrameLength = 100;  // Rotating, ms
+const unsigned long JitterMin = 200;    // Service gap, us
+const unsigned long JitterMax = 3200;
+
+const uint8_t RotateOrder[4] = { 1 << 0, 1 << 1, 1 << 3, 1 << 2 };  // Player 1, 2, 4, 3
+
+struct Write {
+	unsigned long long time;  // us
+	uint8_t leds;
+};
+
+class Recorder : public XboxControllerLEDs_CustomStatic<Recorder, 4> {
+public:
+	std::vector<Write> writes;
+protected:
+	void setLEDs(uint8_t ledStates) { writes.push_back({ ArduinoHost::getMicros(), ledStates }); }
+};
+
+// Runs the rotating pattern for 'NumFrames' frame changes, returning how far
+// the next deadline is from where it should be (in the handler's timebase)
+long drift(XboxLEDTiming policy, boolean precise, uint32_t seed) {
+	ArduinoHost::reset();
+	ArduinoHost::setMicros(1000000ULL);
+
+	HostTest::Random random(seed);
+	Recorder leds;
+	leds.setTiming(policy, precise);
+	leds.setPattern(XboxLEDPattern::Rotating);
+
+	const unsigned long long startMicros = ArduinoHost::getMicros();
+	const unsigned long start = leds.getTime();
+	const unsigned long length = precise ? FrameLength * 1000 : FrameLength;
+
+	while (leds.writes.size() <= NumFrames) {
+		ArduinoHost::advanceMicros(JitterMin + random.below(JitterMax - JitterMin + 1));
+		leds.run();
+	}
+
+	const boolean onTime = (policy != XboxLEDTiming::Serviced);
+	for (unsigned long n = 0; n < leds.writes.size(); n++) {
+		const Write & w = leds.writes[n];
+		CHECK(w.leds == RotateOrder[n % 4]);
+		if (!onTime) continue;
+
+		// Each frame is written on the first run at or after its deadline
+		const unsigned long long deadline = startMicros + n * FrameLength * 1000;
+		if (!CHECK(w.time >= deadline && w.time - deadline < JitterMax)) {
+			fprintf(stderr, "  frame %lu written %lld us from its deadline\n", n, (long long) (w.time - deadline));
+			break;
+		}
+	}
+
+	return (long) (uint32_t) (leds.nextDeadline() - (start + (NumFrames + 1) * length));
+}
+
+void policies() {
+	const uint32_t Seeds[] = { 1, 0x5EED, 0xC0FFEE };
+
+	for (uint32_t seed : Seeds) {
+		for (boolean precise : { false, true }) {
+			CHECK(drift(XboxLEDTiming::CatchUp, precise, seed) == 0);
+			CHECK(drift(XboxLEDTiming::Skip, precise, seed) == 0);
+			CHECK(drift(XboxLEDTiming::Serviced, precise, seed) > 0);
+		}
+	}
+}
+
+}  // End namespace
+
+int main() {
+	policies();
+	return HostTest::finish("Drift");
+}
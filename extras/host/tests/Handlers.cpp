@@ -0,0 +1,140 @@
+/*
+ *  Project     Xbox 360 Controller LEDs Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/Xbox360ControllerLEDs
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *  Description:  Checks that the handler with virtual output, the static
+ *                (CRTP) handler and the direct port output all show the
+ *                same LEDs at every millisecond, for random pattern
+ *                changes and output pauses on both the 1 and 4 LED sets.
+ *                The direct output is tested with its pins on one port and
+ *                split across two, both normal and inverted.
+ */
+
+#include "X360ControllerLEDs.h"
+
+#include "Test.h"
+
+namespace {
+
+// Common controls for each handler under test
+class Subject {
+public:
+	virtual ~Subject() {}
+	virtual void begin() = 0;
+	virtual void setPattern(XboxLEDPattern pattern) = 0;
+	virtual void linkPattern(XboxLEDPattern pattern) = 0;
+	virtual void pauseOutput() = 0;
+	virtual void resumeOutput() = 0;
+	virtual void run() = 0;
+	virtual uint8_t getLastFrame() const = 0;
+	virtual uint8_t readPins() const = 0;  // LED states on the pins
+};
+
+template<class Handler, uint8_t ...pins>
+class PinSubject : public Subject {
+public:
+	PinSubject(boolean inv = false) : leds(inv), inverted(inv) {}
+
+	void begin() { leds.begin(); }
+	void setPattern(XboxLEDPattern pattern) { leds.setPattern(pattern); }
+	void linkPattern(XboxLEDPattern pattern) { leds.linkPattern(pattern); }
+	void pauseOutput() { leds.pauseOutput(); }
+	void resumeOutput() { leds.resumeOutput(); }
+	void run() { leds.run(); }
+	uint8_t getLastFrame() const { return leds.getLastFrame(); }
+
+	uint8_t readPins() const {
+		const uint8_t Pins[] = { pins... };
+		uint8_t states = 0x00;
+		for (uint8_t i = 0; i < sizeof...(pins); i++) {
+			if ((digitalRead(Pins[i]) == HIGH) != inverted) states |= (1 << i);
+		}
+		return states;
+	}
+
+private:
+	Handler leds;
+	const boolean inverted;
+};
+
+template<uint8_t ...pins> using Virtual = PinSubject<XboxControllerLEDs<pins...>, pins...>;
+template<uint8_t ...pins> using Static  = PinSubject<XboxControllerLEDs_Static<pins...>, pins...>;
+template<uint8_t ...pins> using Direct  = PinSubject<XboxControllerLEDs_Direct<pins...>, pins...>;
+
+// Plays the same random commands on every subject, checking after each step
+void compare(Subject * const * subjects, uint8_t count, uint32_t seed, unsigned long length) {
+	HostTest::Random random(seed);
+
+	ArduinoHost::reset();
+	for (uint8_t s = 0; s < count; s++) subjects[s]->begin();
+
+	unsigned long mismatches = 0;
+	for (unsigned long t = 0; t < length; t++) {
+		const uint32_t r = random.below(1000);
+		const XboxLEDPattern pattern = random.pattern();
+		for (uint8_t s = 0; s < count; s++) {
+			Subject & leds = *subjects[s];
+			if (r < 4) leds.setPattern(pattern);
+			else if (r < 12) leds.linkPattern(pattern);
+			else if (r < 13) leds.pauseOutput();
+			else if (r < 15) leds.resumeOutput();
+			leds.run();
+		}
+
+		for (uint8_t s = 1; s < count; s++) {
+			if (subjects[s]->getLastFrame() != subjects[0]->getLastFrame()
+				|| subjects[s]->readPins() != subjects[0]->readPins()) mismatches++;
+		}
+		ArduinoHost::advanceMillis(1);
+	}
+	CHECK(mismatches == 0);
+}
+
+}  // End namespace
+
+int main() {
+	const unsigned long Length = 600000;  // 10 minutes
+
+	for (uint32_t seed = 1; seed <= 4; seed++) {
+		// Port 1: pins 0 - 7, port 2: pins 8 - 15, ...
+		Virtual<0, 1, 2, 3> individual;
+		Static<4, 5, 6, 7> staticPins;
+		Direct<16, 17, 18, 19> sharedPort;
+		Direct<14, 15, 20, 21> splitPorts;
+		Virtual<24, 25, 26, 27> individualInverted(true);
+		Direct<28, 29, 30, 31> sharedInverted(true);
+		Direct<22, 23, 32, 33> splitInverted(true);
+		Subject * const four[] = { &individual, &staticPins, &sharedPort, &splitPorts,
+			&individualInverted, &sharedInverted, &splitInverted };
+		compare(four, sizeof(four) / sizeof(four[0]), seed, Length);
+
+		Virtual<40> single;
+		Static<41> singleStatic;
+		Direct<42> singleDirect;
+		Direct<43> singleInverted(true);
+		Subject * const one[] = { &single, &singleStatic, &singleDirect, &singleInverted };
+		compare(one, sizeof(one) / sizeof(one[0]), seed, Length);
+	}
+
+	return HostTest::finish("Handlers");
+}
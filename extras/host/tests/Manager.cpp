@@ -0,0 +1,224 @@
+/*
+ *  Project     Xbox 360 Controller LEDs Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/Xbox360ControllerLEDs
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *  Description:  Checks that the multi-controller manager writes the same
+ *                LEDs at the same times as one handler per controller, for
+ *                random commands on 50 controllers, and that a controller
+ *                whose animation ends on a blocked link holds its last
+ *                frame without stalling the others.
+ */
+
+#include "X360ControllerLEDs.h"
+#include "X360LEDManager.h"
+#include "X360LEDRegistry.h"
+
+#include "Test.h"
+
+#include <algorithm>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+const uint8_t NumControllers = 50;
+
+struct Write {
+	unsigned long time;
+	uint8_t controller;
+	uint8_t leds;
+
+	bool operator<(const Write & other) const {  // Controllers due at the same time can be written in any order
+		if (time != other.time) return time < other.time;
+		return controller < other.controller;
+	}
+
+	bool operator==(const Write & other) const {
+		return time == other.time && controller == other.controller && leds == other.leds;
+	}
+};
+
+std::vector<Write> writes;
+
+template<uint8_t nleds>
+class Bank : public XboxControllerLEDs_Manager<Bank<nleds>, nleds, NumControllers> {
+public:
+	void begin() {}
+protected:
+	void setLEDs(uint8_t controller, uint8_t ledStates) { writes.push_back({ millis(), controller, ledStates }); }
+};
+
+template<uint8_t nleds>
+class Recorder : public XboxControllerLEDs_CustomStatic<Recorder<nleds>, nleds> {
+public:
+	void begin() {}
+	uint8_t id = 0;
+protected:
+	void setLEDs(uint8_t ledStates) { writes.push_back({ millis(), id, ledStates }); }
+};
+
+struct Command {
+	uint8_t controller;
+	boolean link;
+	XboxLEDPattern pattern;
+};
+
+// One command every few ms on a random controller. Meta patterns are included.
+boolean randomCommand(HostTest::Random & random, Command & cmd) {
+	if (random.below(8) != 0) return false;
+	cmd = { (uint8_t) random.below(NumControllers), random.below(3) != 0, random.pattern() };
+	return true;
+}
+
+template<uint8_t nleds>
+std::vector<Write> managed(uint32_t seed, unsigned long length) {
+	HostTest::Random random(seed);
+	ArduinoHost::reset();
+	writes.clear();
+
+	Bank<nleds> bank;
+	bank.setPatternAll(XboxLEDPattern::Off);
+	for (unsigned long t = 0; t < length; t++) {
+		ArduinoHost::setMillis(t);
+		bank.run(t);
+		Command cmd;
+		if (randomCommand(random, cmd)) {
+			if (cmd.link) bank.linkPattern(cmd.controller, cmd.pattern);
+			else bank.setPattern(cmd.controller, cmd.pattern);
+		}
+	}
+	std::stable_sort(writes.begin(), writes.end());
+	return writes;
+}
+
+template<uint8_t nleds>
+std::vector<Write> separate(uint32_t seed, unsigned long length) {
+	HostTest::Random random(seed);
+	ArduinoHost::reset();
+	writes.clear();
+
+	Recorder<nleds> handlers[NumControllers];
+	for (uint8_t i = 0; i < NumControllers; i++) {
+		handlers[i].id = i;
+		handlers[i].setPattern(XboxLEDPattern::Off);
+	}
+	for (unsigned long t = 0; t < length; t++) {
+		ArduinoHost::setMillis(t);
+		for (uint8_t i = 0; i < NumControllers; i++) handlers[i].run(t);
+		Command cmd;
+		if (randomCommand(random, cmd)) {
+			Recorder<nleds> & leds = handlers[cmd.controller];
+			if (cmd.link) leds.linkPattern(cmd.pattern);
+			else leds.setPattern(cmd.pattern);
+		}
+	}
+	std::stable_sort(writes.begin(), writes.end());
+	return writes;
+}
+
+unsigned long count(const std::vector<Write> & list, uint8_t controller) {
+	unsigned long n = 0;
+	for (const Write & w : list) {
+		if (w.controller == controller) n++;
+	}
+	return n;
+}
+
+// User animation 0 blinks twice, then links to itself. The link can't
+// change the pattern, so the animation ends and its deadline never moves.
+const uint8_t SelfLink[] = {
+	'X', 1,
+	2, 2, 0x40,  // 2 frames, 2 cycles, then animation 0
+	0b0101, 10,  // 100 ms
+	0b1010, 10,
+	0x00,  // Checksum, set below
+};
+
+void blockedLink() {
+	ArduinoHost::reset();
+	writes.clear();
+
+	uint8_t blob[sizeof(SelfLink)];
+	memcpy(blob, SelfLink, sizeof(blob));
+	uint8_t sum = 0;
+	for (size_t i = 0; i < sizeof(blob) - 1; i++) sum += blob[i];
+	blob[sizeof(blob) - 1] = (uint8_t) -sum;
+
+	XboxLEDRegistry<1, 2> registry;
+	CHECK(registry.load(blob, sizeof(blob)) == XboxLEDLoadResult::Ok);
+
+	Bank<4> bank;
+	bank.setUserAnimations(&registry);
+	bank.linkPattern(0, XboxLEDUserPattern(0));
+	bank.setPattern(1, XboxLEDPattern::Rotating);
+
+	for (unsigned long t = 0; t < 2000; t++) {
+		ArduinoHost::setMillis(t);
+		bank.run(t);  // Must return
+	}
+	CHECK(count(writes, 0) == 4);  // 2 cycles of 2 frames, no more
+	CHECK(count(writes, 1) == 20);  // Not held up, every 100 ms
+	CHECK(bank.getLastFrame(0) == 0b1010);  // Last frame held
+	CHECK(bank.getPattern(0) == XboxLEDUserPattern(0));
+
+	// A single handler holds the frame the same way
+	Recorder<4> leds;
+	leds.id = 2;
+	leds.setUserAnimations(&registry);
+	leds.linkPattern(XboxLEDUserPattern(0));
+	for (unsigned long t = 2000; t < 3000; t++) {
+		ArduinoHost::setMillis(t);
+		leds.run();
+	}
+	CHECK(count(writes, 2) == 4);
+	CHECK(leds.getLastFrame() == 0b1010);
+	CHECK(!leds.isAnimating());
+
+	bank.setPattern(0, XboxLEDPattern::Blinking);  // Animates again after a new pattern
+	const unsigned long before = count(writes, 0);
+	for (unsigned long t = 3000; t < 4000; t++) {
+		ArduinoHost::setMillis(t);
+		bank.run(t);
+	}
+	CHECK(count(writes, 0) == before + 3);  // Every 300 ms
+}
+
+}  // End namespace
+
+int main() {
+	alarm(60);  // A pass that never returns fails the test instead of hanging it
+
+	for (uint32_t seed = 1; seed <= 4; seed++) {
+		const std::vector<Write> four = separate<4>(seed, 120000);
+		CHECK(four.size() > 1000);
+		CHECK(managed<4>(seed, 120000) == four);
+
+		const std::vector<Write> one = separate<1>(seed, 120000);
+		CHECK(one.size() > 1000);
+		CHECK(managed<1>(seed, 120000) == one);
+	}
+
+	blockedLink();
+
+	return HostTest::finish("Manager");
+}
@@ -0,0 +1,228 @@
+/*
+ *  Project     Xbox 360 Controller LEDs Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/Xbox360ControllerLEDs
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *  Description:  Checks the queued handler. Commands queued between two
+ *                calls to run() are all applied on the next one, in
+ *                order, with 'linkPattern' or 'setPattern' as queued. A
+ *                full queue drops and counts the extra commands, and
+ *                invalid LED reports are never queued.
+ */
+
+#include "X360ControllerLEDs.h"
+#include "X360LEDQueue.h"
+#include "X360LEDRegistry.h"
+
+#include "Test.h"
+
+#include <vector>
+
+namespace {
+
+struct Call {
+	XboxLEDPattern pattern;
+	boolean link;
+
+	bool operator==(const Call & other) const {
+		return pattern == other.pattern && link == other.link;
+	}
+};
+
+// Records the changes the queue makes, then passes them on
+class Spy : public XboxControllerLEDs_CustomStatic<Spy, 4> {
+public:
+	using Base = XboxControllerLEDs_CustomStatic<Spy, 4>;
+
+	std::vector<Call> calls;
+
+	void begin() {}
+
+	void setPattern(XboxLEDPattern pattern) {
+		calls.push_back({ pattern, false });
+		Base::setPattern(pattern);
+	}
+
+	void linkPattern(XboxLEDPattern pattern) {
+		calls.push_back({ pattern, true });
+		Base::linkPattern(pattern);
+	}
+
+protected:
+	void setLEDs(uint8_t) {}
+};
+
+using Queued = XboxControllerLEDs_Queued<Spy, 8>;
+
+void start(Queued & leds) {
+	ArduinoHost::reset();
+	ArduinoHost::setMillis(1000);
+	leds.setPattern(XboxLEDPattern::Off);
+	leds.calls.clear();
+}
+
+// ---- Order -------------------------------------------------------------|
+
+// The host's "flash, then solid" pair arriving back to back. Applied
+// directly the second would be dropped until the flash ends; queued,
+// both reach the handler in order on the next run.
+void backToBack() {
+	Queued leds;
+	start(leds);
+
+	CHECK(leds.queueLinkPattern(XboxLEDPattern::Flash1));
+	CHECK(leds.queueLinkPattern(XboxLEDPattern::Player1));
+	CHECK(leds.calls.empty());  // Nothing until run()
+	CHECK(leds.getPattern() == XboxLEDPattern::Off);
+
+	ArduinoHost::advanceMillis(1);
+	leds.run();
+	const std::vector<Call> expected = { { XboxLEDPattern::Flash1, true }, { XboxLEDPattern::Player1, true } };
+	CHECK(leds.calls == expected);
+	CHECK(leds.getPattern() == XboxLEDPattern::Flash1);  // Player 1 is next, after the flashes
+
+	for (unsigned long t = 0; t < 5000; t++) {
+		ArduinoHost::advanceMillis(1);
+		leds.run();
+	}
+	CHECK(leds.getPattern() == XboxLEDPattern::Player1);
+	CHECK(leds.calls.size() == 2);  // Nothing else was queued
+}
+
+// The link flag picks the call, and doesn't leak into the pattern
+void linkFlag() {
+	Queued leds;
+	start(leds);
+
+	const XboxLEDPattern user = XboxLEDUserPattern(0x3F);  // Highest ID, 0x7F
+	CHECK(leds.queuePattern(XboxLEDPattern::Player3));
+	CHECK(leds.queueLinkPattern(XboxLEDPattern::Rotating));
+	CHECK(leds.queuePattern(user));
+	CHECK(leds.queueLinkPattern(user));
+	CHECK(leds.queueLinkPattern(XboxLEDPattern::Off));
+	CHECK(leds.queuePattern(XboxLEDPattern::Alternating));
+
+	leds.run();
+	const std::vector<Call> expected = {
+		{ XboxLEDPattern::Player3, false },
+		{ XboxLEDPattern::Rotating, true },
+		{ user, false },
+		{ user, true },
+		{ XboxLEDPattern::Off, true },
+		{ XboxLEDPattern::Alternating, false },
+	};
+	CHECK(leds.calls == expected);
+	CHECK(leds.getPattern() == XboxLEDPattern::Alternating);
+
+	leds.calls.clear();
+	leds.run();
+	CHECK(leds.calls.empty());  // Drained
+}
+
+// ---- Full Queue --------------------------------------------------------|
+
+void full() {
+	Queued leds;
+	start(leds);
+
+	// 8 slots, one kept open
+	const uint8_t Sent = 10;
+	uint8_t accepted = 0;
+	for (uint8_t i = 0; i < Sent; i++) {
+		if (leds.queuePattern((XboxLEDPattern) (i % (uint8_t) XboxLEDPattern::NumPatterns))) accepted++;
+	}
+	CHECK(accepted == 7);
+	CHECK(leds.getDroppedCommands() == Sent - accepted);
+
+	leds.run();
+	CHECK(leds.calls.size() == 7);
+	for (uint8_t i = 0; i < leds.calls.size(); i++) {
+		CHECK(leds.calls[i].pattern == (XboxLEDPattern) i);  // The first ones, in order
+	}
+
+	// Room again once drained, and the drop count is kept
+	CHECK(leds.queueLinkPattern(XboxLEDPattern::Player2));
+	CHECK(leds.getDroppedCommands() == 3);
+	leds.run();
+	CHECK(leds.calls.size() == 8);
+	CHECK(leds.getPattern() == XboxLEDPattern::Player2);
+
+	// Wraps around the ring many times without losing or repeating any
+	HostTest::Random random(0x5EED);
+	std::vector<Call> queued;
+	leds.calls.clear();
+	for (unsigned long i = 0; i < 1000; i++) {
+		const uint8_t n = random.below(8);
+		for (uint8_t j = 0; j < n; j++) {
+			const Call c = { (XboxLEDPattern) random.below((uint8_t) XboxLEDPattern::NumPatterns), random.below(2) == 1 };
+			const boolean ok = c.link ? leds.queueLinkPattern(c.pattern) : leds.queuePattern(c.pattern);
+			CHECK(ok == (j < 7));
+			if (ok) queued.push_back(c);
+		}
+		leds.run();
+	}
+	CHECK(leds.calls == queued);
+}
+
+// ---- Reports -----------------------------------------------------------|
+
+void reports() {
+	Queued leds;
+	start(leds);
+
+	const uint8_t valid[] = { 0x01, 0x03, 0x0A };  // Rotating
+	const uint8_t badType[] = { 0x00, 0x03, 0x0A };
+	const uint8_t badLength[] = { 0x01, 0x02, 0x0A };
+	const uint8_t badPattern[] = { 0x01, 0x03, 0x0E };  // Past 'Alternating'
+	const uint8_t metaPattern[] = { 0x01, 0x03, (uint8_t) XboxLEDPattern::Previous };
+
+	CHECK(!leds.queueReport(badType, sizeof(badType)));
+	CHECK(!leds.queueReport(badLength, sizeof(badLength)));
+	CHECK(!leds.queueReport(badPattern, sizeof(badPattern)));
+	CHECK(!leds.queueReport(metaPattern, sizeof(metaPattern)));
+	CHECK(!leds.queueReport(valid, 2));  // Too short
+	CHECK(leds.getDroppedCommands() == 0);  // Rejected, not dropped
+
+	leds.run();
+	CHECK(leds.calls.empty());
+
+	CHECK(leds.queueReport(valid, sizeof(valid)));
+	leds.run();
+	const std::vector<Call> expected = { { XboxLEDPattern::Rotating, true } };  // Linked, like the controller
+	CHECK(leds.calls == expected);
+	CHECK(leds.getPattern() == XboxLEDPattern::Rotating);
+
+	// A full queue rejects valid reports too, and counts them
+	for (uint8_t i = 0; i < 7; i++) CHECK(leds.queueReport(valid, sizeof(valid)));
+	CHECK(!leds.queueReport(valid, sizeof(valid)));
+	CHECK(leds.getDroppedCommands() == 1);
+}
+
+}  // End namespace
+
+int main() {
+	backToBack();
+	linkFlag();
+	full();
+	reports();
+	return HostTest::finish("Queue");
+}
@@ -0,0 +1,168 @@
+/*
+ *  Project     Xbox 360 Controller LEDs Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/Xbox360ControllerLEDs
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *  Description:  Checks the Render tool against sampling. Random command
+ *                lists are rendered by build/Render (run from this folder
+ *                by 'make test'), and the CSV must match the trace from
+ *                calling run() every millisecond with the same commands,
+ *                for the 1 and 4 LED sets.
+ */
+
+#include "X360ControllerLEDs.h"
+
+#include "../tools/Commands.h"
+#include "Test.h"
+
+#include <stdlib.h>
+#include <string>
+#include <unistd.h>
+
+namespace {
+
+using HostTools::Action;
+using HostTools::Command;
+
+const char * const RenderPath = "build/Render";
+
+template<uint8_t nleds>
+class Recorder : public XboxControllerLEDs_CustomStatic<Recorder<nleds>, nleds> {
+public:
+	void begin() {}
+protected:
+	void setLEDs(uint8_t ledStates) { (void) ledStates; }
+};
+
+std::vector<Command> randomCommands(uint32_t seed, size_t count) {
+	HostTest::Random random(seed);
+	std::vector<Command> commands;
+	unsigned long t = 0;
+	for (size_t i = 0; i < count; i++) {
+		const uint32_t gap = random.below(4);
+		t += (gap == 0) ? 0 : (gap == 1) ? random.below(50) : (gap == 2) ? random.below(2000) : random.below(20000);
+
+		Command cmd = Command();
+		cmd.time = t;
+		cmd.action = random.below(3) != 0 ? Action::Link : Action::Set;
+		cmd.pattern = (XboxLEDPattern) random.below((uint8_t) XboxLEDPattern::NumPatterns);
+		commands.push_back(cmd);
+	}
+	return commands;
+}
+
+// One CSV row, in the same format as Render
+void row(std::string & csv, unsigned long time, XboxLEDPattern pattern, uint8_t leds, uint8_t nleds) {
+	char buffer[64];
+	int n = snprintf(buffer, sizeof(buffer), "%lu,%u", time, (unsigned) pattern);
+	for (uint8_t i = 0; i < nleds; i++) n += snprintf(buffer + n, sizeof(buffer) - n, ",%u", (leds >> i) & 1);
+	csv.append(buffer, n);
+	csv += '\n';
+}
+
+// run() every millisecond, with the commands at each millisecond after it.
+// Rows are written when the pattern or LEDs change, once per millisecond.
+template<uint8_t nleds>
+std::string sampled(const std::vector<Command> & commands, unsigned long length) {
+	ArduinoHost::reset();
+	Recorder<nleds> leds;
+	leds.setPattern(XboxLEDPattern::Off);
+
+	std::string csv = "ms,pattern";
+	for (uint8_t i = 0; i < nleds; i++) csv += ",led" + std::to_string(i + 1);
+	csv += '\n';
+
+	XboxLEDPattern lastPattern = XboxLEDPattern::Null;  // First row at 0 ms, after any commands at 0
+	uint8_t lastLEDs = 0xFF;
+
+	size_t c = 0;
+	for (unsigned long t = 0; t < length; t++) {
+		ArduinoHost::setMillis(t);
+		leds.run();
+		for (; c < commands.size() && commands[c].time == t; c++) {
+			if (commands[c].action == Action::Link) leds.linkPattern(commands[c].pattern);
+			else leds.setPattern(commands[c].pattern);
+		}
+
+		if (leds.getPattern() != lastPattern || leds.getLastFrame() != lastLEDs) {
+			lastPattern = leds.getPattern();
+			lastLEDs = leds.getLastFrame();
+			row(csv, t, lastPattern, lastLEDs, nleds);
+		}
+	}
+	return csv;
+}
+
+std::string rendered(const std::vector<Command> & commands, uint8_t nleds) {
+	char path[] = "/tmp/SampledXXXXXX";
+	const int fd = mkstemp(path);
+	if (!CHECK(fd >= 0)) return "";
+
+	FILE * file = fdopen(fd, "w");
+	for (const Command & cmd : commands) HostTools::writeCommand(file, cmd);
+	fclose(file);
+
+	const std::string command = std::string(RenderPath) + " -n " + std::to_string(nleds) + " " + path;
+	FILE * out = popen(command.c_str(), "r");
+	std::string csv;
+	char buffer[256];
+	size_t n;
+	while (out != NULL && (n = fread(buffer, 1, sizeof(buffer), out)) > 0) csv.append(buffer, n);
+	CHECK(out != NULL && pclose(out) == 0);
+
+	unlink(path);
+	return csv;
+}
+
+template<uint8_t nleds>
+void compare(const std::vector<Command> & commands) {
+	const unsigned long length = commands.back().time + 10000;  // Render's default
+	const std::string expected = sampled<nleds>(commands, length);
+	const std::string actual = rendered(commands, nleds);
+
+	if (!CHECK(actual == expected)) {
+		size_t line = 0;  // Start of the first row that differs
+		for (size_t i = 0; i < actual.size() && i < expected.size() && actual[i] == expected[i]; i++) {
+			if (actual[i] == '\n') line = i + 1;
+		}
+		fprintf(stderr, "  %u LEDs, Render: \"%s\", sampled: \"%s\"\n", (unsigned) nleds,
+			actual.substr(line, actual.find('\n', line) - line).c_str(),
+			expected.substr(line, expected.find('\n', line) - line).c_str());
+	}
+}
+
+}  // End namespace
+
+int main() {
+	if (access(RenderPath, X_OK) != 0) {
+		fprintf(stderr, "%s not found, run from extras/host after 'make'\n", RenderPath);
+		return 1;
+	}
+
+	for (uint32_t seed = 1; seed <= 8; seed++) {
+		const std::vector<Command> commands = randomCommands(seed, 200);
+		compare<4>(commands);
+		compare<1>(commands);
+	}
+
+	return HostTest::finish("Sampled");
+}
@@ -0,0 +1,175 @@
+/*
+ *  Project     Xbox 360 Controller LEDs Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/Xbox360ControllerLEDs
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *  Description:  Checks the tables built by the animation sequence types
+ *                against hand-written tables: run-length compression,
+ *                repeats, shared frames between animations, and the
+ *                built-in 4 LED set rebuilt from sequences.
+ */
+
+#include "X360ControllerLEDs.h"
+#include "X360LEDSequence.h"
+#include "X360LEDWide.h"
+
+#include "Test.h"
+
+#include <type_traits>
+
+namespace {
+
+using Xbox360Controller_LEDs::LED_Frame;
+using Xbox360Controller_LEDs::LED_AnimationInfo;
+using Xbox360Controller_LEDs::LED_Select;
+using Xbox360Controller_LEDs::XboxLEDFrameWord;
+using Xbox360Controller_LEDs::XboxLEDAnimations;
+namespace Sequence = Xbox360Controller_LEDs::Sequence;
+
+// ---- Shared Helpers ----------------------------------------------------|
+
+static_assert(std::is_same<XboxLEDAnimation<XboxLEDHold<1, 100>, 2, XboxLEDPattern::Player1>,
+	Xbox360Controller_LEDs::LED_SequenceAnimation<XboxLEDHold<1, 100>, 2, XboxLEDPattern::Player1>>::value,
+	"XboxLEDAnimation must name the sequence animation");
+
+static_assert(std::is_same<LED_Select<true, int, char>::type, int>::value &&
+	std::is_same<LED_Select<false, int, char>::type, char>::value,
+	"LED_Select picks the first type when true");
+
+static_assert(std::is_same<XboxLEDFrameWord<8>::type, uint8_t>::value &&
+	std::is_same<XboxLEDFrameWord<9>::type, uint16_t>::value &&
+	std::is_same<XboxLEDFrameWord<32>::type, uint32_t>::value &&
+	std::is_same<XboxLEDFrameWord<33>::type, uint64_t>::value,
+	"Wide frame words must be the smallest type that fits");
+
+bool sameFrame(const LED_Frame & a, const LED_Frame & b) {
+	return a.LEDs == b.LEDs && a.Duration == b.Duration;
+}
+
+// Compares one pattern's animation against the expected frames, ignoring
+// where in the frame table it was placed
+template <class Set>
+void checkAnimation(XboxLEDPattern pattern, const LED_Frame * frames, const LED_AnimationInfo & expected) {
+	const LED_AnimationInfo & built = Set::Animations[(uint8_t) pattern];
+
+	CHECK(built.NFrames == expected.NFrames);
+	CHECK(built.NCycles == expected.NCycles);
+	CHECK(built.Next == expected.Next);
+
+	for (uint8_t i = 0; i < built.NFrames && i < expected.NFrames; i++) {
+		CHECK(sameFrame(Set::Frames[built.Offset + i], frames[expected.Offset + i]));
+	}
+}
+
+// ---- Compression -------------------------------------------------------|
+
+using Off = XboxLEDHold<0b0000, 200>;
+using On  = XboxLEDHold<0b1111, 300>;
+
+using Merged = XboxLEDAnimation<XboxLEDSequence<Off, Off, On, On, On, XboxLEDHold<0b1111, 0>>>;  // Runs merge, forever absorbs
+using Repeated = XboxLEDAnimation<XboxLEDRepeat<3, On, Off>, 5, XboxLEDPattern::Previous>;
+using Split = XboxLEDAnimation<XboxLEDSequence<XboxLEDHold<1, 400000>, XboxLEDHold<1, 400000>>>;  // Too long to merge
+
+static_assert(Merged::NumFrames == 2, "Matching frames must merge");
+static_assert(Repeated::NumFrames == 6, "Alternating frames must not merge");
+static_assert(Split::NumFrames == 2, "Frames too long for one tick count must not merge");
+static_assert(XboxLEDRepeat<150, On, Off>::Frames::NumFrames == 300,
+	"Frame counts must not wrap at 255 (see tests/fail/TooManyFrames.cpp)");
+
+template <class Anim, uint8_t n>
+void checkFrames(const LED_Frame (&expected)[n]) {
+	using Table = Sequence::Table<typename Anim::Frames>;
+	CHECK(Anim::NumFrames == n);
+	for (uint8_t i = 0; i < n && i < Anim::NumFrames; i++) {
+		CHECK(sameFrame(Table::Frames[i], expected[i]));
+	}
+}
+
+void compression() {
+	const LED_Frame merged[] = { LED_Frame(0b0000, 400), LED_Frame(0b1111, 0) };
+	checkFrames<Merged>(merged);
+
+	const LED_Frame repeated[] = {
+		LED_Frame(0b1111, 300), LED_Frame(0b0000, 200),
+		LED_Frame(0b1111, 300), LED_Frame(0b0000, 200),
+		LED_Frame(0b1111, 300), LED_Frame(0b0000, 200),
+	};
+	checkFrames<Repeated>(repeated);
+
+	const LED_Frame split[] = { LED_Frame(1, 400000), LED_Frame(1, 400000) };
+	checkFrames<Split>(split);
+}
+
+// ---- Built-in Set ------------------------------------------------------|
+
+// The built-in 4 LED animations, rebuilt from sequences
+const uint8_t P1 = 1 << 0, P2 = 1 << 1, P3 = 1 << 2, P4 = 1 << 3;
+
+using Blink = XboxLEDSequence<XboxLEDHold<0b0000, 300>, XboxLEDHold<0b1111, 300>>;
+using Slow  = XboxLEDSequence<XboxLEDHold<0b0000, 700>, XboxLEDHold<0b1111, 300>>;
+
+template <uint8_t player, XboxLEDPattern next>
+using Flash = XboxLEDAnimation<XboxLEDSequence<XboxLEDHold<0b0000, 300>, XboxLEDHold<player, 300>>, 3, next>;
+
+template <uint8_t player>
+using Solid = XboxLEDAnimation<XboxLEDHold<player, 0>>;
+
+using BuiltIn = XboxLEDAnimationSet<4,
+	Solid<0b0000>,
+	XboxLEDAnimation<Blink, 4, XboxLEDPattern::BlinkSlow>,
+	Flash<P1, XboxLEDPattern::Player1>,
+	Flash<P2, XboxLEDPattern::Player2>,
+	Flash<P3, XboxLEDPattern::Player3>,
+	Flash<P4, XboxLEDPattern::Player4>,
+	Solid<P1>, Solid<P2>, Solid<P3>, Solid<P4>,
+	XboxLEDAnimation<XboxLEDSequence<XboxLEDHold<P1, 100>, XboxLEDHold<P2, 100>, XboxLEDHold<P4, 100>, XboxLEDHold<P3, 100>>,
+		50, XboxLEDPattern::Previous>,
+	XboxLEDAnimation<Slow, 1, XboxLEDPattern::Previous>,
+	XboxLEDAnimation<Slow, 16, XboxLEDPattern::Previous>,
+	XboxLEDAnimation<XboxLEDSequence<XboxLEDHold<0b1010, 300>, XboxLEDHold<0b0101, 300>>, 7, XboxLEDPattern::Previous>
+>;
+
+static_assert(BuiltIn::NumFrames == XboxLEDAnimations<4>::Frames_End,
+	"Rebuilt set must share frames the same way as the built-in table");
+
+void builtIn() {
+	using Tables = XboxLEDAnimations<4>;
+
+	for (uint8_t p = 0; p < (uint8_t) XboxLEDPattern::NumPatterns; p++) {
+		checkAnimation<BuiltIn>((XboxLEDPattern) p, Tables::Frames, Tables::Animations[p]);
+	}
+
+	// The descriptor handed to the handlers points to both tables
+	CHECK(BuiltIn::Set.Frames == BuiltIn::Frames && BuiltIn::Set.Animations == BuiltIn::Animations);
+
+	// BlinkOnce and BlinkSlow share their frames
+	CHECK(BuiltIn::Animations[(uint8_t) XboxLEDPattern::BlinkOnce].Offset ==
+		BuiltIn::Animations[(uint8_t) XboxLEDPattern::BlinkSlow].Offset);
+}
+
+}  // End namespace
+
+int main() {
+	compression();
+	builtIn();
+	return HostTest::finish("Sequences");
+}
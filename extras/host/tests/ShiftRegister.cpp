@@ -0,0 +1,187 @@
+/*
+ *  Project     Xbox 360 Controller LEDs Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/Xbox360ControllerLEDs
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *  Description:  Checks the shift register frame buffer and output
+ *                against the transfers recorded by the host SPI library.
+ *                Writes are packed into the chain in order, across byte
+ *                boundaries, and sent last byte first. A run() that
+ *                changes any controller sends exactly one transfer and
+ *                latches once, and one that changes nothing sends none.
+ */
+
+#include "X360ControllerLEDs.h"
+#include "X360LEDShiftRegister.h"
+
+#include "Test.h"
+
+#include <SPI.h>
+
+namespace {
+
+const uint8_t LatchPin = 10;
+
+// Last 'n' bytes sent, in chain order (the first register was sent last)
+template <uint8_t n>
+boolean sent(const uint8_t (&expected)[n]) {
+	for (uint8_t i = 0; i < n; i++) {
+		if (SPI.log[(SPI.bytes - 1 - i) % SPIClass::LogSize] != expected[i]) return false;
+	}
+	return true;
+}
+
+unsigned long latches() {
+	return ArduinoHost::getWriteCount(LatchPin) / 2;  // High then low
+}
+
+// ---- Frame Buffer ------------------------------------------------------|
+
+void buffer() {
+	ArduinoHost::reset();
+	XboxLEDShiftBuffer<3, LatchPin> chain;
+
+	const unsigned long transfers = SPI.transactions;
+	chain.begin();  // Clears the registers
+	CHECK(SPI.transactions == transfers + 1);
+	CHECK(latches() == 1);
+	CHECK(sent<3>({ 0x00, 0x00, 0x00 }));
+	CHECK(!chain.isDirty());
+
+	// Straddles the first two registers: bits 6 - 9
+	chain.write(6, 4, 0b1011);
+	CHECK(chain.getBuffer()[0] == 0b11000000);
+	CHECK(chain.getBuffer()[1] == 0b00000010);
+	CHECK(chain.isDirty());
+
+	// Last 3 bits of the chain, the rest is out of range and ignored
+	chain.write(21, 5, 0b11101);
+	CHECK(chain.getBuffer()[2] == 0b10100000);
+
+	chain.flush();
+	CHECK(SPI.transactions == transfers + 2);
+	CHECK(latches() == 2);
+	CHECK(sent<3>({ 0b11000000, 0b00000010, 0b10100000 }));
+
+	// Writing the same bits again isn't a change
+	chain.write(6, 4, 0b1011);
+	chain.write(16, 8, 0b10100000);
+	CHECK(!chain.isDirty());
+	chain.flush();
+	CHECK(SPI.transactions == transfers + 2);
+	CHECK(latches() == 2);
+
+	// One bit back, one more transfer of the whole chain
+	chain.write(7, 1, 0);
+	chain.flush();
+	CHECK(SPI.transactions == transfers + 3);
+	CHECK(sent<3>({ 0b01000000, 0b00000010, 0b10100000 }));
+}
+
+// ---- Output ------------------------------------------------------------|
+
+const uint8_t NumControllers = 5;  // 20 LEDs, 3 registers with 4 spare bits
+
+using Registers = XboxControllerLEDs_ShiftRegisters<4, NumControllers, LatchPin>;
+static_assert(Registers::NumRegisters == 3, "Five 4 LED controllers need 3 registers");
+
+// Chain contents for the controllers' current frames
+void pack(const Registers & leds, boolean inverted, uint8_t (&chain)[Registers::NumRegisters]) {
+	for (uint8_t & b : chain) b = 0x00;
+	for (uint8_t c = 0; c < NumControllers; c++) {
+		const uint8_t frame = inverted ? ~leds.getLastFrame(c) : leds.getLastFrame(c);
+		for (uint8_t i = 0; i < 4; i++) {
+			const uint8_t bit = c * 4 + i;
+			if (frame & (1 << i)) chain[bit / 8] |= 1 << (bit % 8);
+		}
+	}
+}
+
+void output(boolean inverted, uint32_t seed) {
+	ArduinoHost::reset();
+	ArduinoHost::setMillis(1000);
+	HostTest::Random random(seed);
+
+	Registers leds(inverted);
+	unsigned long transfers = SPI.transactions;
+	leds.begin();
+	CHECK(SPI.transactions == transfers + 1);  // One for the registers, none for the controllers
+
+	uint8_t shown[Registers::NumRegisters];
+	pack(leds, inverted, shown);
+	CHECK(sent(shown));
+	CHECK(shown[0] == (inverted ? 0xFF : 0x00));
+	CHECK(shown[2] == (inverted ? 0x0F : 0x00));  // Spare bits stay clear
+
+	unsigned long changes = 0, idle = 0;
+	for (unsigned long t = 0; t < 30000; t++) {
+		if (random.below(200) == 0) {
+			const uint8_t controller = random.below(NumControllers);
+			transfers = SPI.transactions;
+			if (random.below(2)) leds.setPattern(controller, random.pattern());
+			else leds.linkPattern(controller, random.pattern());
+			CHECK(SPI.transactions == transfers);  // Buffered until run()
+		}
+
+		transfers = SPI.transactions;
+		const unsigned long latched = latches();
+		ArduinoHost::advanceMillis(1);
+		leds.run();
+
+		uint8_t chain[Registers::NumRegisters];
+		pack(leds, inverted, chain);
+		const boolean changed = memcmp(chain, shown, sizeof(chain)) != 0;
+		if (changed) {
+			CHECK(SPI.transactions == transfers + 1);
+			CHECK(latches() == latched + 1);
+			CHECK(sent(chain));
+			memcpy(shown, chain, sizeof(chain));
+			changes++;
+		}
+		else {
+			CHECK(SPI.transactions == transfers);
+			CHECK(latches() == latched);
+			idle++;
+		}
+	}
+	CHECK(changes > 100);
+	CHECK(idle > 100);
+
+	// A flush with nothing changed sends nothing
+	transfers = SPI.transactions;
+	leds.flush();
+	CHECK(SPI.transactions == transfers);
+}
+
+}  // End namespace
+
+int main() {
+	buffer();
+
+	const uint32_t seeds[] = { 1, 0x5EED, 0xC0FFEE };
+	for (uint32_t seed : seeds) {
+		output(false, seed);
+		output(true, seed);
+	}
+
+	return HostTest::finish("ShiftRegister");
+}
@@ -0,0 +1,146 @@
+/*
+ *  Project     Xbox 360 Controller LEDs Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/Xbox360ControllerLEDs
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *  Description:  Stress test for handler snapshots. One thread plays
+ *                random patterns, links and timing changes on a wrapped
+ *                handler while three others read snapshots as fast as
+ *                they can. Every snapshot must be one the writer could
+ *                have published: a real pattern, a frame within its
+ *                animation, and the LEDs from that frame in the table.
+ *                Run with 'make test-tsan' to check the sequence lock
+ *                under ThreadSanitizer.
+ */
+
+#include "X360ControllerLEDs.h"
+#include "X360LEDSnapshot.h"
+
+#include "Test.h"
+
+#include <atomic>
+#include <thread>
+
+namespace {
+
+using Xbox360Controller_LEDs::LED_AnimationInfo;
+using Xbox360Controller_LEDs::LED_Frame;
+using Animations = Xbox360Controller_LEDs::XboxLEDAnimations<4>;
+
+const unsigned long Steps = 200000;  // Writer iterations
+const unsigned int NumReaders = 3;
+
+class Output : public XboxControllerLEDs_CustomStatic<Output, 4> {
+public:
+	void begin() {}
+protected:
+	void setLEDs(uint8_t ledStates) { leds = ledStates; }
+	uint8_t leds = 0;  // Writer thread only
+};
+
+using Handler = XboxControllerLEDs_Snapshots<Output>;
+using Snapshot = Handler::Snapshot;
+
+std::atomic<unsigned int> started(0);  // Readers running, the writer waits for all of them
+std::atomic<bool> done(false);
+
+// Result of one reader, only looked at after it's joined
+struct Reader {
+	unsigned long reads = 0;
+	unsigned long bad = 0;
+	Snapshot first;  // First bad snapshot
+};
+
+boolean valid(const Snapshot & s) {
+	if ((uint8_t) s.pattern > (uint8_t) XboxLEDPattern::Max) return false;
+	const LED_AnimationInfo & animation = Animations::Animations[(uint8_t) s.pattern];
+	if (s.frameIndex >= animation.NFrames) return false;
+	return s.leds == Animations::Frames[animation.Offset + s.frameIndex].LEDs;
+}
+
+void read(const Handler & leds, Reader & result) {
+	started.fetch_add(1, std::memory_order_release);
+	do {
+		const Snapshot s = leds.getSnapshot();
+		result.reads++;
+		if (!valid(s)) {
+			if (result.bad++ == 0) result.first = s;
+		}
+	} while (!done.load(std::memory_order_acquire));
+}
+
+void write(Handler & leds) {
+	const XboxLEDTiming policies[] = { XboxLEDTiming::Serviced, XboxLEDTiming::CatchUp, XboxLEDTiming::Skip };
+	HostTest::Random random(0x5EED);
+
+	for (unsigned long i = 0; i < Steps; i++) {
+		const uint32_t r = random.below(100);
+		const XboxLEDPattern pattern = (XboxLEDPattern) random.below((uint8_t) XboxLEDPattern::NumPatterns);
+		if (r < 2) leds.setPattern(pattern);
+		else if (r < 4) leds.linkPattern(pattern);
+		else if (r == 4) leds.setTiming(policies[random.below(3)], random.below(2));
+
+		ArduinoHost::advanceMillis(random.below(40));
+		leds.run();
+	}
+}
+
+}  // End namespace
+
+int main() {
+	ArduinoHost::reset();
+	ArduinoHost::setMillis(1000);
+
+	Handler leds;
+	leds.begin();
+	leds.setPattern(XboxLEDPattern::Rotating);
+	CHECK(valid(leds.getSnapshot()));
+
+	Reader results[NumReaders];
+	std::thread readers[NumReaders];
+	for (unsigned int i = 0; i < NumReaders; i++) {
+		readers[i] = std::thread(read, std::cref(leds), std::ref(results[i]));
+	}
+
+	while (started.load(std::memory_order_acquire) < NumReaders) std::this_thread::yield();
+	write(leds);
+	done.store(true, std::memory_order_release);
+	for (std::thread & t : readers) t.join();
+
+	for (const Reader & r : results) {
+		CHECK(r.bad == 0);
+		if (r.bad != 0) {
+			fprintf(stderr, "  %lu of %lu snapshots invalid, first: pattern %u, frame %u, cycle %u, leds 0x%02X\n",
+				r.bad, r.reads, (unsigned) r.first.pattern, r.first.frameIndex, r.first.cycle, r.first.leds);
+		}
+		CHECK(r.reads > 0);
+	}
+
+	// After the writer stops, the readers see its final state
+	const Snapshot last = leds.getSnapshot();
+	CHECK(last.pattern == leds.getPattern());
+	CHECK(last.frameIndex == leds.getFrameIndex());
+	CHECK(last.leds == leds.getLastFrame());
+	CHECK(last.deadline == leds.nextDeadline());
+
+	return HostTest::finish("Snapshots");
+}
@@ -0,0 +1,166 @@
+/*
+ *  Project     Xbox 360 Controller LEDs Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/Xbox360ControllerLEDs
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *  Description:  Checks the statistics counters (XBOX_LED_STATS, set for
+ *                this test and its copy of the library by the Makefile).
+ *                Services frames with a known, random lateness and checks
+ *                every counter and the lateness figures against it. A
+ *                linked animation that hands off counts as a linked
+ *                change, and one whose link is blocked does not.
+ */
+
+#include "X360ControllerLEDs.h"
+#include "X360LEDRegistry.h"
+
+#include "Test.h"
+
+#include <string.h>
+
+#ifndef XBOX_LED_STATS
+#error "The stats test must be built with XBOX_LED_STATS"
+#endif
+
+namespace {
+
+class Recorder : public XboxControllerLEDs_CustomStatic<Recorder, 4> {
+public:
+	unsigned long writes = 0;
+protected:
+	void setLEDs(uint8_t) { writes++; }
+};
+
+// User animation 0 blinks twice, then links to itself
+const uint8_t SelfLink[] = {
+	'X', 1,
+	2, 2, 0x40,  // 2 frames, 2 cycles, then animation 0
+	0b0101, 10,  // 100 ms
+	0b1010, 10,
+	0x00,  // Checksum, set below
+};
+
+void runFor(Recorder & leds, unsigned long ms) {
+	for (unsigned long t = 0; t < ms; t++) {
+		ArduinoHost::advanceMillis(1);
+		leds.run();
+	}
+}
+
+// Every frame of 'Rotating' is serviced once a little early (nothing due)
+// and once late by a random amount, shorter than the frame
+void timing(uint32_t seed) {
+	ArduinoHost::reset();
+	ArduinoHost::setMillis(1000);
+	HostTest::Random random(seed);
+
+	Recorder leds;
+	leds.setPattern(XboxLEDPattern::Rotating);
+	CHECK(leds.getStats().patternChanges == 1);
+	CHECK(leds.getStats().writes == 1);
+	CHECK(leds.getStats().runs == 0);
+	leds.resetStats();
+	leds.writes = 0;
+
+	const unsigned long Frames = 500;
+	unsigned long late = 0, lateMax = 0, lateTotal = 0;
+	for (unsigned long i = 0; i < Frames; i++) {
+		const unsigned long deadline = leds.nextDeadline();
+		ArduinoHost::setMillis(deadline - 1);
+		leds.run();
+
+		const unsigned long lateness = (random.below(4) == 0) ? 0 : random.below(50);  // Some on time
+		ArduinoHost::setMillis(deadline + lateness);
+		leds.run();
+
+		if (lateness != 0) late++;
+		if (lateness > lateMax) lateMax = lateness;
+		lateTotal += lateness;
+	}
+
+	const XboxLEDStats stats = leds.getStats();
+	CHECK(stats.runs == 2 * Frames);
+	CHECK(stats.frames == Frames);
+	CHECK(stats.writes == Frames);  // Every frame changes the LEDs
+	CHECK(stats.writes == leds.writes);
+	CHECK(stats.lateFrames == late);
+	CHECK(stats.latenessMax == lateMax);
+	CHECK(stats.latenessTotal == lateTotal);
+	CHECK(stats.latenessMean() == lateTotal / Frames);
+	CHECK(stats.patternChanges == 0);
+	CHECK(stats.linkedChanges == 0);
+	CHECK(stats.ignoredLinks == 0);
+
+	// Links that don't change the pattern are counted, others aren't
+	leds.linkPattern(XboxLEDPattern::Rotating);
+	CHECK(leds.getStats().ignoredLinks == 1);
+	leds.setPattern(XboxLEDPattern::Rotating);
+	CHECK(leds.getStats().ignoredLinks == 1);
+	leds.linkPattern(XboxLEDPattern::Player2);
+	CHECK(leds.getStats().ignoredLinks == 1);
+	CHECK(leds.getStats().patternChanges == 1);
+
+	leds.resetStats();
+	const XboxLEDStats cleared = leds.getStats();
+	CHECK(cleared.runs == 0 && cleared.frames == 0 && cleared.writes == 0);
+	CHECK(cleared.patternChanges == 0 && cleared.linkedChanges == 0 && cleared.ignoredLinks == 0);
+	CHECK(cleared.lateFrames == 0 && cleared.latenessMax == 0 && cleared.latenessTotal == 0);
+	CHECK(cleared.latenessMean() == 0);
+}
+
+void linkedChanges() {
+	ArduinoHost::reset();
+
+	Recorder leds;
+	leds.setPattern(XboxLEDPattern::Player1);
+	leds.linkPattern(XboxLEDPattern::BlinkOnce);  // Then back to Player 1
+	runFor(leds, 2000);
+	CHECK(leds.getPattern() == XboxLEDPattern::Player1);
+	CHECK(leds.getStats().linkedChanges == 1);
+	CHECK(leds.getStats().patternChanges == 3);
+
+	uint8_t blob[sizeof(SelfLink)];
+	memcpy(blob, SelfLink, sizeof(blob));
+	uint8_t sum = 0;
+	for (size_t i = 0; i < sizeof(blob) - 1; i++) sum += blob[i];
+	blob[sizeof(blob) - 1] = (uint8_t) -sum;
+
+	XboxLEDRegistry<1, 2> registry;
+	CHECK(registry.load(blob, sizeof(blob)) == XboxLEDLoadResult::Ok);
+
+	leds.setUserAnimations(&registry);
+	leds.resetStats();
+	leds.linkPattern(XboxLEDUserPattern(0));
+	runFor(leds, 2000);
+	CHECK(!leds.isAnimating());  // Holding the last frame
+	CHECK(leds.getStats().linkedChanges == 0);  // Blocked, no change
+	CHECK(leds.getStats().patternChanges == 1);
+}
+
+}  // End namespace
+
+int main() {
+	const uint32_t seeds[] = { 1, 0x5EED, 0xC0FFEE };
+	for (uint32_t seed : seeds) timing(seed);
+	linkedChanges();
+	return HostTest::finish("Stats");
+}
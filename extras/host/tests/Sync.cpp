@@ -0,0 +1,152 @@
+/*
+ *  Project     Xbox 360 Controller LEDs Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/Xbox360ControllerLEDs
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *  Description:  Checks the synchronized group. A pattern set with an
+ *                epoch must land on the same frame, with the same next
+ *                deadline, as a group that started the pattern at the
+ *                epoch and played every frame since, including when the
+ *                pattern is already running. Attached members must not
+ *                show their own frames until they are detached.
+ */
+
+#include "X360ControllerLEDs.h"
+#include "X360LEDSync.h"
+
+#include "Test.h"
+
+#include <vector>
+
+namespace {
+
+using Group = XboxControllerLEDs_SyncGroup<4, 2>;
+
+class Member : public XboxControllerLEDs_Custom<4> {
+public:
+	void begin() {}
+	std::vector<uint8_t> writes;
+protected:
+	void setLEDs(uint8_t ledStates) { writes.push_back(ledStates); }
+};
+
+// ---- Epochs ------------------------------------------------------------|
+
+// Started at 'epoch' and played frame by frame up to 'now'
+void played(Group & group, XboxLEDPattern pattern, unsigned long epoch, unsigned long now, boolean precise) {
+	group.setTiming(XboxLEDTiming::Skip, precise);
+	ArduinoHost::setMicros(precise ? epoch : epoch * 1000ULL);
+	group.setPattern(pattern);
+	while (group.isAnimating() && Group::reached(now, group.nextDeadline())) {
+		group.run(group.nextDeadline());
+	}
+}
+
+boolean samePosition(const Group & a, const Group & b) {
+	return a.getPattern() == b.getPattern() && a.getLastFrame() == b.getLastFrame()
+		&& a.getFrameIndex() == b.getFrameIndex() && a.isAnimating() == b.isAnimating()
+		&& (!a.isAnimating() || a.nextDeadline() == b.nextDeadline());
+}
+
+void epochs() {
+	HostTest::Random random(0xE90C);
+
+	for (int trial = 0; trial < 2000; trial++) {
+		const boolean precise = random.below(2);
+		const XboxLEDPattern pattern = (XboxLEDPattern) random.below(Group::NumPatterns);  // Meta patterns are ignored
+		const XboxLEDPattern before = (XboxLEDPattern) random.below(Group::NumPatterns);
+		const unsigned long epoch = 1000 + random.below(100000);
+		const unsigned long now = epoch + random.below(precise ? 60000000UL : 600000UL);
+
+		Group reference;
+		played(reference, pattern, epoch, now, precise);
+
+		Group group;
+		group.setTiming(XboxLEDTiming::Skip, precise);
+		ArduinoHost::setMicros(1000ULL);
+		group.setPattern(before);  // Already running a pattern, maybe the same one
+		ArduinoHost::setMicros(precise ? now : now * 1000ULL);
+		group.setPattern(pattern, epoch);
+
+		if (!CHECK(samePosition(group, reference))) {
+			fprintf(stderr, "  pattern %u, epoch %lu, now %lu, %s\n",
+				(unsigned) pattern, epoch, now, precise ? "micros" : "millis");
+			break;
+		}
+	}
+
+	// Far past epochs (up to 2^31, past that they look like the future)
+	// land on the frame for their place in the cycle
+	Group group;
+	const unsigned long now = 0xFFFFFF00UL;
+	ArduinoHost::setMillis(now);
+	for (unsigned long ago : { 0UL, 99UL, 100UL, 350UL, 86400000UL, 0x7FFFFFFFUL }) {
+		group.setPattern(XboxLEDPattern::Rotating, now - ago);
+		CHECK(group.getFrameIndex() == (ago / 100) % 4);
+		CHECK(group.nextDeadline() == now - ago % 100 + 100);
+	}
+
+	// A future epoch starts now
+	group.setPattern(XboxLEDPattern::Rotating, now + 1000);
+	CHECK(group.getFrameIndex() == 0 && group.nextDeadline() == now + 100);
+}
+
+// ---- Members -----------------------------------------------------------|
+
+void members() {
+	ArduinoHost::reset();
+	Group group;
+	Member a;
+
+	a.setPattern(XboxLEDPattern::Player1);
+	CHECK(a.writes.size() == 1 && a.writes.back() == 0b0001);
+
+	group.setPattern(XboxLEDPattern::Player3);
+	CHECK(group.attach(a));
+	CHECK(a.writes.size() == 2 && a.writes.back() == 0b0100);  // Joins the group
+
+	a.setPattern(XboxLEDPattern::Blinking);  // Paused, not shown
+	for (int i = 0; i < 2000; i++) {
+		ArduinoHost::advanceMillis(1);
+		a.run();
+		group.run();
+	}
+	CHECK(a.writes.size() == 2);
+
+	group.setPattern(XboxLEDPattern::Player2);
+	CHECK(a.writes.size() == 3 && a.writes.back() == 0b0010);
+
+	group.detach(a);
+	CHECK(group.getNumMembers() == 0);
+	CHECK(a.writes.size() == 4 && a.writes.back() == a.getLastFrame());  // Back to its own frame
+
+	group.setPattern(XboxLEDPattern::Player4);
+	CHECK(a.writes.size() == 4);
+}
+
+}  // End namespace
+
+int main() {
+	epochs();
+	members();
+	return HostTest::finish("Sync");
+}
@@ -0,0 +1,87 @@
+/*
+ *  Project     Xbox 360 Controller LEDs Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/Xbox360ControllerLEDs
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *  Description:  Checks shared by the host tests. Each test is its own
+ *                program that prints the failed checks and exits non-zero
+ *                if there were any, so 'make test' stops on the first
+ *                failing test.
+ */
+
+#ifndef HostTest_h
+#define HostTest_h
+
+#include "X360ControllerLEDs.h"
+
+#include <stdio.h>
+
+#define CHECK(condition) HostTest::check((condition), #condition, __FILE__, __LINE__)
+
+namespace HostTest {
+
+unsigned long checks = 0;
+unsigned long failures = 0;
+
+inline boolean check(boolean ok, const char * condition, const char * file, int line) {
+	checks++;
+	if (!ok) {
+		failures++;
+		fprintf(stderr, "%s:%d: check failed: %s\n", file, line, condition);
+	}
+	return ok;
+}
+
+// Repeatable pseudo-random numbers (xorshift32), so a failing run can be replayed
+class Random {
+public:
+	Random(uint32_t seed) : state(seed != 0 ? seed : 1) {}
+
+	uint32_t next() {
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return state;
+	}
+
+	uint32_t below(uint32_t n) {
+		return next() % n;
+	}
+
+	// Any pattern, including the meta patterns
+	XboxLEDPattern pattern() {
+		return (XboxLEDPattern) below((uint8_t) XboxLEDPattern::Null + 1);
+	}
+
+private:
+	uint32_t state;
+};
+
+// Reports the result, returned from main()
+inline int finish(const char * name) {
+	printf("%s: %lu checks, %lu failed\n", name, checks, failures);
+	return failures == 0 ? 0 : 1;
+}
+
+}  // End namespace
+
+#endif
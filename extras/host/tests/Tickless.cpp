@@ -0,0 +1,143 @@
+/*
+ *  Project     Xbox 360 Controller LEDs Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/Xbox360ControllerLEDs
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *  Description:  Checks that firmware which sleeps from one frame deadline
+ *                to the next with run(now) writes the same LEDs at the
+ *                same times as polling run() every millisecond, for random
+ *                setPattern / linkPattern commands on the 1 and 4 LED sets,
+ *                and that timeToNextFrame() agrees with nextDeadline().
+ */
+
+#include "X360ControllerLEDs.h"
+
+#include "Test.h"
+
+#include <vector>
+
+namespace {
+
+struct Write {
+	unsigned long time;
+	uint8_t leds;
+
+	bool operator==(const Write & other) const {
+		return time == other.time && leds == other.leds;
+	}
+};
+
+struct Command {
+	unsigned long time;
+	boolean link;
+	XboxLEDPattern pattern;
+};
+
+template<uint8_t nleds>
+class Recorder : public XboxControllerLEDs_CustomStatic<Recorder<nleds>, nleds> {
+public:
+	void begin() { this->setPattern(XboxLEDPattern::Off); }
+	std::vector<Write> writes;
+protected:
+	void setLEDs(uint8_t ledStates) { writes.push_back({ millis(), ledStates }); }
+};
+
+template<class Handler>
+void apply(Handler & leds, const Command & cmd) {
+	if (cmd.link) leds.linkPattern(cmd.pattern);
+	else leds.setPattern(cmd.pattern);
+}
+
+template<uint8_t nleds>
+std::vector<Write> polled(const std::vector<Command> & commands, unsigned long length) {
+	ArduinoHost::reset();
+	Recorder<nleds> leds;
+	leds.begin();
+
+	size_t c = 0;
+	for (unsigned long t = 0; t < length; t++) {
+		ArduinoHost::setMillis(t);
+		leds.run();
+		for (; c < commands.size() && commands[c].time == t; c++) apply(leds, commands[c]);
+	}
+	return leds.writes;
+}
+
+template<uint8_t nleds>
+std::vector<Write> tickless(const std::vector<Command> & commands, unsigned long length) {
+	ArduinoHost::reset();
+	Recorder<nleds> leds;
+	leds.begin();
+
+	unsigned long now = 0;
+	auto sleepUntil = [&](unsigned long wake) {  // Frames due before 'wake', each on its deadline
+		while (leds.isAnimating()) {
+			const unsigned long deadline = leds.nextDeadline();
+			CHECK(leds.timeToNextFrame(now) == deadline - now);
+			if (deadline >= wake) break;
+			now = deadline;
+			ArduinoHost::setMillis(now);
+			leds.run(now);
+		}
+		CHECK(leds.isAnimating() || leds.timeToNextFrame(now) == Recorder<nleds>::NoDeadline);
+	};
+
+	for (const Command & cmd : commands) {
+		sleepUntil(cmd.time + 1);  // Frames due at the same time come first
+		now = cmd.time;
+		ArduinoHost::setMillis(now);
+		apply(leds, cmd);
+	}
+	sleepUntil(length);
+	return leds.writes;
+}
+
+std::vector<Command> randomCommands(uint32_t seed, size_t count) {
+	HostTest::Random random(seed);
+	std::vector<Command> commands;
+	unsigned long t = 0;
+	for (size_t i = 0; i < count; i++) {
+		const uint32_t gap = random.below(4);
+		t += (gap == 0) ? 0 : (gap == 1) ? random.below(50) : (gap == 2) ? random.below(2000) : random.below(20000);
+		commands.push_back({ t, random.below(3) != 0, random.pattern() });
+	}
+	return commands;
+}
+
+}  // End namespace
+
+int main() {
+	for (uint32_t seed = 1; seed <= 8; seed++) {
+		const std::vector<Command> commands = randomCommands(seed, 500);
+		const unsigned long length = commands.back().time + 30000;
+
+		const std::vector<Write> four = polled<4>(commands, length);
+		CHECK(four.size() > 500);
+		CHECK(tickless<4>(commands, length) == four);
+
+		const std::vector<Write> one = polled<1>(commands, length);
+		CHECK(one.size() > 500);
+		CHECK(tickless<1>(commands, length) == one);
+	}
+
+	return HostTest::finish("Tickless");
+}
@@ -0,0 +1,198 @@
+/*
+ *  Project     Xbox 360 Controller LEDs Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/Xbox360ControllerLEDs
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *  Description:  Checks the calls to 'updateLEDs' with both the virtual
+ *                and the static (CRTP) handler. A frame change that
+ *                leaves the LEDs the same must not call the output, and
+ *                'changed' must be the LEDs that differ from the last
+ *                write: all of them for 'rewriteFrame' (even while paused)
+ *                and the first write after 'resumeOutput'.
+ */
+
+#include "X360ControllerLEDs.h"
+
+#include "Test.h"
+
+#include <vector>
+
+namespace {
+
+struct Update {
+	uint8_t leds;
+	uint8_t changed;
+};
+
+class Virtual : public XboxControllerLEDs_Custom<4> {
+public:
+	std::vector<Update> calls;
+	void begin() {}
+protected:
+	void setLEDs(uint8_t) { CHECK(false); }  // Never called, 'updateLEDs' is overridden
+	void updateLEDs(uint8_t ledStates, uint8_t changed) { calls.push_back({ ledStates, changed }); }
+};
+
+class Static : public XboxControllerLEDs_CustomStatic<Static, 4> {
+public:
+	std::vector<Update> calls;
+	void begin() {}
+protected:
+	void setLEDs(uint8_t) { CHECK(false); }
+	void updateLEDs(uint8_t ledStates, uint8_t changed) { calls.push_back({ ledStates, changed }); }
+};
+
+// What the output should have been sent, kept alongside the handler
+template <class Handler>
+class Model {
+public:
+	Model(Handler & h) : leds(h) {}
+
+	// After any change to the handler: one call if the LEDs differ from
+	// the last write (all of them if 'force'), none otherwise
+	void check(boolean force = false) {
+		const size_t calls = leds.calls.size() - seen;
+		const uint8_t frame = leds.getLastFrame();
+
+		if (paused && !force) {
+			CHECK(calls == 0);
+		}
+		else if (force || !known || frame != shown) {
+			if (CHECK(calls == 1)) {
+				const Update & u = leds.calls.back();
+				CHECK(u.leds == frame);
+				CHECK(u.changed == ((force || !known) ? 0xFF : (uint8_t) (shown ^ frame)));
+			}
+			shown = frame;
+			known = !paused;  // Rewritten while paused, could still be changed by someone else
+		}
+		else {
+			CHECK(calls == 0);  // Same LEDs, nothing to write
+		}
+		seen = leds.calls.size();
+	}
+
+	void pause() { paused = true; known = false; }
+	void resume() { paused = false; }
+
+private:
+	Handler & leds;
+	size_t seen = 0;
+	uint8_t shown = 0;
+	boolean known = false;
+	boolean paused = false;
+};
+
+// Random pattern changes, links, pauses and rewrites, checked every ms
+template <class Handler>
+void randomUpdates(uint32_t seed) {
+	ArduinoHost::reset();
+	ArduinoHost::setMillis(1000);
+	HostTest::Random random(seed);
+
+	Handler leds;
+	Model<Handler> model(leds);
+	leds.setPattern(XboxLEDPattern::Off);
+	model.check();
+
+	for (unsigned long t = 0; t < 60000; t++) {
+		const uint32_t r = random.below(1000);
+		if (r < 4) {
+			leds.setPattern(random.pattern());
+			model.check();
+		}
+		else if (r < 8) {
+			leds.linkPattern(random.pattern());
+			model.check();
+		}
+		else if (r == 8) {
+			leds.pauseOutput();
+			model.pause();
+			model.check();
+		}
+		else if (r == 9) {
+			leds.resumeOutput();
+			model.resume();
+			model.check();
+		}
+		else if (r == 10) {
+			leds.rewriteFrame();
+			model.check(true);
+		}
+
+		ArduinoHost::advanceMillis(1);
+		leds.run();
+		model.check();
+	}
+}
+
+// Frame and pattern changes that keep the same LEDs
+template <class Handler>
+void sameLEDs() {
+	ArduinoHost::reset();
+	ArduinoHost::setMillis(1000);
+
+	Handler leds;
+	leds.setPattern(XboxLEDPattern::Player1);
+	CHECK(leds.calls.size() == 1);
+
+	leds.setPattern(XboxLEDPattern::Rotating);  // Starts on the Player 1 LEDs
+	CHECK(leds.calls.size() == 1);
+
+	// Flash 1 ends on the Player 1 LEDs, then links to Player 1
+	leds.setPattern(XboxLEDPattern::Off);
+	leds.linkPattern(XboxLEDPattern::Flash1);
+	while (leds.getPattern() == XboxLEDPattern::Flash1) {
+		const size_t before = leds.calls.size();
+		const uint8_t frame = leds.getLastFrame();
+		ArduinoHost::advanceMillis(1);
+		leds.run();
+
+		if (leds.getPattern() == XboxLEDPattern::Player1) {
+			CHECK(frame == leds.getLastFrame());
+			CHECK(leds.calls.size() == before);  // Handed off, no write
+		}
+	}
+	CHECK(leds.getPattern() == XboxLEDPattern::Player1);
+	CHECK(leds.calls.back().leds == leds.getLastFrame());
+
+	// Every write toggles exactly the LEDs that changed
+	for (size_t i = 1; i < leds.calls.size(); i++) {
+		CHECK(leds.calls[i].changed == (uint8_t) (leds.calls[i - 1].leds ^ leds.calls[i].leds));
+		CHECK(leds.calls[i].changed != 0);
+	}
+}
+
+}  // End namespace
+
+int main() {
+	const uint32_t seeds[] = { 1, 0x5EED, 0xC0FFEE };
+	for (uint32_t seed : seeds) {
+		randomUpdates<Virtual>(seed);
+		randomUpdates<Static>(seed);
+	}
+
+	sameLEDs<Virtual>();
+	sameLEDs<Static>();
+
+	return HostTest::finish("Updates");
+}
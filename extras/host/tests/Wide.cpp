@@ -0,0 +1,162 @@
+/*
+ *  Project     Xbox 360 Controller LEDs Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/Xbox360ControllerLEDs
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *  Description:  Checks the wide handler against the 4 LED handler, for
+ *                4, 7, 8, 16, 32 and 64 LEDs. With the same random
+ *                commands, every pattern but 'Rotating' must show the 4
+ *                LED states scaled to the ring (one quadrant per player)
+ *                at the same times. 'Rotating' must chase one segment
+ *                around the ring, one step per frame, for 50 rotations.
+ */
+
+#include "X360ControllerLEDs.h"
+#include "X360LEDWide.h"
+
+#include "Test.h"
+
+namespace {
+
+class Quad : public XboxControllerLEDs_CustomStatic<Quad, 4> {
+protected:
+	void setLEDs(uint8_t) {}
+};
+
+template<uint8_t nleds>
+class Ring : public XboxControllerLEDs_Wide<Ring<nleds>, nleds> {
+public:
+	using Word = typename XboxControllerLEDs_Wide<Ring<nleds>, nleds>::Word;
+	void begin() {}
+	Word written = 0;
+	unsigned long writes = 0;
+protected:
+	void setLEDs(Word ledStates) { written = ledStates; writes++; }
+};
+
+// Segments [first, last)
+uint64_t span(uint8_t first, uint8_t last) {
+	uint64_t bits = 0;
+	for (uint8_t i = first; i < last; i++) bits |= (uint64_t) 1 << i;
+	return bits;
+}
+
+// Players around the ring are 1, 2, 4, 3 (bits 0, 1, 3, 2)
+uint64_t scaled(uint8_t states, uint8_t nleds) {
+	const uint8_t Order[4] = { 0, 1, 3, 2 };
+	uint64_t bits = 0;
+	for (uint8_t q = 0; q < 4; q++) {
+		if (states & (1 << Order[q])) bits |= span(q * nleds / 4, (q + 1) * nleds / 4);
+	}
+	return bits;
+}
+
+// ---- Scaled Patterns ---------------------------------------------------|
+
+template<uint8_t nleds>
+void scaledPatterns(uint32_t seed) {
+	ArduinoHost::reset();
+	HostTest::Random random(seed);
+
+	Quad quad;
+	Ring<nleds> ring;
+	quad.setPattern(XboxLEDPattern::Off);
+	ring.setPattern(XboxLEDPattern::Off);
+
+	unsigned long next = 0;  // Time of the next command
+	for (unsigned long t = 0; t < 200000; t++) {
+		ArduinoHost::setMillis(t);
+		quad.run();
+		ring.run();
+
+		if (t == next) {
+			XboxLEDPattern pattern;
+			do pattern = random.pattern(); while (pattern == XboxLEDPattern::Rotating);
+			if (random.below(3) != 0) {
+				quad.linkPattern(pattern);
+				ring.linkPattern(pattern);
+			}
+			else {
+				quad.setPattern(pattern);
+				ring.setPattern(pattern);
+			}
+			next = t + 1 + random.below(random.below(2) ? 500 : 8000);
+		}
+
+		const uint64_t expected = scaled(quad.getLastFrame(), nleds);
+		if (!CHECK(ring.getPattern() == quad.getPattern() && (uint64_t) ring.getLastFrame() == expected
+			&& (uint64_t) ring.written == expected))
+		{
+			fprintf(stderr, "  %u LEDs at %lu ms, pattern %u\n", (unsigned) nleds, t, (unsigned) quad.getPattern());
+			return;
+		}
+	}
+}
+
+// ---- Rotating ----------------------------------------------------------|
+
+template<uint8_t nleds>
+void rotating() {
+	ArduinoHost::reset();
+
+	Ring<nleds> ring;
+	ring.setPattern(XboxLEDPattern::Player3);
+	ring.linkPattern(XboxLEDPattern::Rotating);  // 50 rotations, then back to Player 3
+
+	// One rotation in about the time of the 4 LED one (400 ms), at least 10 ms per step
+	const unsigned long step = ((400 / nleds) / 10 != 0) ? (400 / nleds) / 10 * 10 : 10;
+	const unsigned long length = 50 * nleds * step;
+
+	for (unsigned long t = 0; t < length; t++) {
+		ArduinoHost::setMillis(t);
+		ring.run();
+		const uint8_t segment = (t / step) % nleds;
+		if (!CHECK(ring.getPattern() == XboxLEDPattern::Rotating && (uint64_t) ring.written == (uint64_t) 1 << segment)) {
+			fprintf(stderr, "  %u LEDs at %lu ms\n", (unsigned) nleds, t);
+			return;
+		}
+	}
+	CHECK(ring.writes == 1 + 50UL * nleds);  // Player 3, then one write per step
+
+	ArduinoHost::setMillis(length);
+	ring.run();
+	CHECK(ring.getPattern() == XboxLEDPattern::Player3);
+	CHECK((uint64_t) ring.written == scaled(1 << 2, nleds));
+}
+
+template<uint8_t nleds>
+void check() {
+	for (uint32_t seed = 1; seed <= 3; seed++) scaledPatterns<nleds>(seed);
+	rotating<nleds>();
+}
+
+}  // End namespace
+
+int main() {
+	check<4>();
+	check<7>();
+	check<8>();
+	check<16>();
+	check<32>();
+	check<64>();
+	return HostTest::finish("Wide");
+}
@@ -0,0 +1,235 @@
+/*
+ *  Project     Xbox 360 Controller LEDs Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/Xbox360ControllerLEDs
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *  Description:  Plays the same animations twice, once from a clock that
+ *                starts at 1 s and once from a clock where millis() and
+ *                micros() both roll over 2.5 s in, and checks that the
+ *                LED outputs change at the same times in both. Covers the
+ *                handler with each timing policy and timebase, tickless
+ *                run(now), the manager, sync groups, snapshots and fades.
+ */
+
+#include "X360ControllerLEDs.h"
+#include "X360LEDFade.h"
+#include "X360LEDManager.h"
+#include "X360LEDSnapshot.h"
+#include "X360LEDSync.h"
+
+#include "Test.h"
+
+#include <vector>
+
+namespace {
+
+const unsigned long long Reference = 1000000;  // us, no rollover
+const unsigned long long Rollover = (1ULL << 32) * 1000 - 2500000;  // us, both clocks wrap 2.5 s in
+const unsigned long Length = 8000;  // ms
+
+// One output change, at a time relative to the start of the run (us)
+struct Event {
+	unsigned long long time;
+	uint8_t source;
+	uint32_t value;
+
+	bool operator==(const Event & other) const {
+		return time == other.time && source == other.source && value == other.value;
+	}
+};
+
+std::vector<Event> events;
+unsigned long long origin = 0;
+
+void record(uint8_t source, uint32_t value) {
+	events.push_back({ ArduinoHost::getMicros() - origin, source, value });
+}
+
+void start(unsigned long long us) {
+	ArduinoHost::reset();
+	ArduinoHost::setMicros(us);
+	origin = us;
+	events.clear();
+}
+
+unsigned long elapsedMillis() {
+	return (unsigned long) ((ArduinoHost::getMicros() - origin) / 1000);
+}
+
+// Uneven but repeatable service intervals, 1 - 5 ms
+unsigned long stepLength(unsigned long i) {
+	return 1 + (i * 7) % 5;
+}
+
+
+// ---- Outputs |
+
+class Recorder : public XboxControllerLEDs_CustomStatic<Recorder, 4> {
+public:
+	void begin() {}
+protected:
+	void setLEDs(uint8_t ledStates) { record(0, ledStates); }
+};
+
+class Member : public XboxControllerLEDs_Custom<4> {
+public:
+	Member(uint8_t n) : id(n) {}
+	void begin() {}
+protected:
+	void setLEDs(uint8_t ledStates) { record(id, ledStates); }
+	const uint8_t id;
+};
+
+class Bank : public XboxControllerLEDs_Manager<Bank, 4, 3> {
+public:
+	void begin() {}
+protected:
+	void setLEDs(uint8_t controller, uint8_t ledStates) { record(controller, ledStates); }
+};
+
+class Fader : public XboxControllerLEDs_CustomFade<Fader, 4> {
+public:
+	void begin() {}
+protected:
+	void setLevels(const uint8_t * levels) { record(0, levels[0] | (uint32_t) levels[1] << 8); }
+};
+
+
+// ---- Scenarios |
+
+// Player 1, then Alternating (which goes back to Player 1), then Rotating
+template<class Handler>
+void play(Handler & leds, unsigned long at) {
+	if (at == 0) leds.setPattern(XboxLEDPattern::Player1);
+	else if (at == 100) leds.linkPattern(XboxLEDPattern::Alternating);
+	else if (at == 5000) leds.setPattern(XboxLEDPattern::Rotating);
+}
+
+template<class Handler>
+void serviced(Handler & leds) {
+	unsigned long next = 0;
+	for (unsigned long i = 0; elapsedMillis() < Length; i++) {
+		const unsigned long at = elapsedMillis();
+		for (; next <= at; next += 100) play(leds, next);
+		leds.run();
+		ArduinoHost::advanceMillis(stepLength(i));
+	}
+}
+
+std::vector<Event> handler(unsigned long long us, XboxLEDTiming timing, boolean precise) {
+	start(us);
+	Recorder leds;
+	leds.setTiming(timing, precise);
+	serviced(leds);
+	return events;
+}
+
+// Sleeps until the next frame or command, like firmware without a tick
+std::vector<Event> tickless(unsigned long long us) {
+	start(us);
+	Recorder leds;
+	const unsigned long commands[] = { 0, 100, 5000, Length };
+	for (unsigned long c : commands) {
+		while (elapsedMillis() < c) {
+			const unsigned long wait = leds.timeToNextFrame(millis());
+			if (wait == Recorder::NoDeadline || elapsedMillis() + wait > c) {
+				ArduinoHost::advanceMillis(c - elapsedMillis());
+				break;
+			}
+			ArduinoHost::advanceMillis(wait);
+			leds.run(millis());
+		}
+		play(leds, c);
+	}
+	return events;
+}
+
+std::vector<Event> manager(unsigned long long us) {
+	start(us);
+	Bank bank;
+	bank.setPattern(0, XboxLEDPattern::Rotating);
+	bank.setPattern(1, XboxLEDPattern::Alternating);
+	bank.linkPattern(2, XboxLEDPattern::Flash3);
+	for (unsigned long i = 0; elapsedMillis() < Length; i++) {
+		bank.run();
+		ArduinoHost::advanceMillis(stepLength(i));
+	}
+	return events;
+}
+
+std::vector<Event> sync(unsigned long long us) {
+	start(us);
+	XboxControllerLEDs_SyncGroup<4, 2> group;
+	Member a(1), b(2);
+	group.attach(a);
+	group.attach(b);
+	group.setPattern(XboxLEDPattern::Rotating, millis() - 250);  // Started before this run
+	for (unsigned long i = 0; elapsedMillis() < Length; i++) {
+		group.run();
+		ArduinoHost::advanceMillis(stepLength(i));
+	}
+	return events;
+}
+
+std::vector<Event> snapshots(unsigned long long us) {
+	start(us);
+	XboxControllerLEDs_Snapshots<Recorder> leds;
+	leds.setTiming(XboxLEDTiming::Skip);
+	leds.setPattern(XboxLEDPattern::Rotating);
+	for (unsigned long i = 0; elapsedMillis() < Length; i++) {
+		leds.run();
+		const unsigned long wait = leds.getSnapshot().timeToNextFrame(millis());
+		CHECK(wait == leds.timeToNextFrame(millis()));
+		record(9, wait);
+		ArduinoHost::advanceMillis(stepLength(i));
+	}
+	return events;
+}
+
+std::vector<Event> fade(unsigned long long us) {
+	start(us);
+	Fader leds;
+	leds.setFade(200);
+	serviced(leds);
+	return events;
+}
+
+}  // End namespace
+
+int main() {
+	const XboxLEDTiming policies[] = { XboxLEDTiming::Serviced, XboxLEDTiming::CatchUp, XboxLEDTiming::Skip };
+	for (XboxLEDTiming timing : policies) {
+		for (int precise = 0; precise <= 1; precise++) {
+			const std::vector<Event> expected = handler(Reference, timing, precise);
+			CHECK(expected.size() > 20);
+			CHECK(handler(Rollover, timing, precise) == expected);
+		}
+	}
+
+	CHECK(tickless(Rollover) == tickless(Reference));
+	CHECK(manager(Rollover) == manager(Reference));
+	CHECK(sync(Rollover) == sync(Reference));
+	CHECK(snapshots(Rollover) == snapshots(Reference));
+	CHECK(fade(Rollover) == fade(Reference));
+
+	return HostTest::finish("Wrap");
+}
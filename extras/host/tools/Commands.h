@@ -0,0 +1,170 @@
+/*
+ *  Project     Xbox 360 Controller LEDs Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/Xbox360ControllerLEDs
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *  Description:  Pattern command traces shared by the host tools. Each
+ *                line is "<ms> [controller] <set|link> <pattern>" or
+ *                "<ms> [controller] report <bytes>"; see Render.cpp for
+ *                the details. The controller index is optional and
+ *                defaults to 0.
+ */
+
+#ifndef HostCommands_h
+#define HostCommands_h
+
+#include "X360ControllerLEDs.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+namespace HostTools {
+
+const char * const PatternNames[(uint8_t) XboxLEDPattern::NumPatterns] = {
+	"Off", "Blinking", "Flash1", "Flash2", "Flash3", "Flash4",
+	"Player1", "Player2", "Player3", "Player4",
+	"Rotating", "BlinkOnce", "BlinkSlow", "Alternating",
+};
+
+enum class Action { Set, Link, Report };
+
+struct Command {
+	unsigned long time;
+	unsigned int controller;
+	Action action;
+	XboxLEDPattern pattern;
+	uint8_t report[8];  // Raw bytes, for 'Report'
+	uint8_t reportLength;
+};
+
+inline boolean parsePattern(const char * str, XboxLEDPattern & pattern) {
+	if (isdigit((unsigned char) str[0])) {
+		char * end;
+		const unsigned long n = strtoul(str, &end, 10);
+		if (*end != '\0' || n >= (uint8_t) XboxLEDPattern::NumPatterns) return false;
+		pattern = (XboxLEDPattern) n;
+		return true;
+	}
+	for (uint8_t i = 0; i < (uint8_t) XboxLEDPattern::NumPatterns; i++) {
+		if (strcasecmp(str, PatternNames[i]) == 0) {
+			pattern = (XboxLEDPattern) i;
+			return true;
+		}
+	}
+	return false;
+}
+
+// Hex bytes separated by whitespace, e.g. "01 03 0A"
+inline boolean parseBytes(const char * str, uint8_t * bytes, uint8_t max, uint8_t & length) {
+	length = 0;
+	while (true) {
+		while (isspace((unsigned char) *str)) str++;
+		if (*str == '\0') return length != 0;
+		if (length >= max) return false;
+
+		char * end;
+		const unsigned long value = strtoul(str, &end, 16);
+		if (end == str || value > 0xFF) return false;
+		bytes[length++] = (uint8_t) value;
+		str = end;
+	}
+}
+
+inline boolean readCommands(FILE * in, std::vector<Command> & commands) {
+	char line[128];
+	unsigned int lineNum = 0;
+
+	while (fgets(line, sizeof(line), in) != NULL) {
+		lineNum++;
+
+		char * start = line;
+		while (isspace((unsigned char) *start)) start++;
+		if (*start == '\0' || *start == '#') continue;  // Blank or comment
+
+		Command cmd;
+		char verb[8];
+		int args = 0;
+		if (sscanf(start, "%lu %u %7s %n", &cmd.time, &cmd.controller, verb, &args) != 3) {
+			cmd.controller = 0;
+			if (sscanf(start, "%lu %7s %n", &cmd.time, verb, &args) != 2) {
+				fprintf(stderr, "Line %u: expected \"<ms> [controller] <set|link|report> ...\"\n", lineNum);
+				return false;
+			}
+		}
+
+		if (strcmp(verb, "set") == 0) cmd.action = Action::Set;
+		else if (strcmp(verb, "link") == 0) cmd.action = Action::Link;
+		else if (strcmp(verb, "report") == 0) cmd.action = Action::Report;
+		else {
+			fprintf(stderr, "Line %u: unknown command \"%s\"\n", lineNum, verb);
+			return false;
+		}
+
+		if (cmd.action == Action::Report) {
+			if (!parseBytes(start + args, cmd.report, sizeof(cmd.report), cmd.reportLength)) {
+				fprintf(stderr, "Line %u: expected up to %u hex bytes\n", lineNum, (unsigned) sizeof(cmd.report));
+				return false;
+			}
+		}
+		else {
+			char name[32];
+			if (sscanf(start + args, "%31s", name) != 1 || !parsePattern(name, cmd.pattern)) {
+				fprintf(stderr, "Line %u: unknown pattern\n", lineNum);
+				return false;
+			}
+		}
+
+		if (!commands.empty() && cmd.time < commands.back().time) {
+			fprintf(stderr, "Line %u: commands must be in time order\n", lineNum);
+			return false;
+		}
+
+		commands.push_back(cmd);
+	}
+	return true;
+}
+
+// Writes a command in the same format, so it can be read back
+inline void writeCommand(FILE * out, const Command & cmd) {
+	fprintf(out, "%lu %u ", cmd.time, cmd.controller);
+	switch (cmd.action) {
+	case(Action::Set):
+		fprintf(out, "set %s\n", PatternNames[(uint8_t) cmd.pattern]);
+		break;
+	case(Action::Link):
+		fprintf(out, "link %s\n", PatternNames[(uint8_t) cmd.pattern]);
+		break;
+	case(Action::Report):
+		fprintf(out, "report");
+		for (uint8_t i = 0; i < cmd.reportLength; i++) fprintf(out, " %02X", cmd.report[i]);
+		fprintf(out, "\n");
+		break;
+	}
+}
+
+}  // End namespace
+
+#endif
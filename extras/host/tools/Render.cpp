@@ -0,0 +1,265 @@
+/*
+ *  Project     Xbox 360 Controller LEDs Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/Xbox360ControllerLEDs
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *  Description:  Renders a list of pattern commands into the exact LED
+ *                timeline, without sampling. The clock jumps straight from
+ *                one frame deadline to the next, so hours of animation take
+ *                milliseconds to render.
+ *
+ *                Usage: Render [-n 1|4] [-f csv|vcd] [-d ms] [file]
+ *                    -n    number of LEDs / animation set (default 4)
+ *                    -f    output format (default csv)
+ *                    -d    length of the timeline in ms (default: 10 s
+ *                          after the last command)
+ *                    file  commands to render (default stdin)
+ *
+ *                Each command line is "<ms> <set|link> <pattern>", with
+ *                the pattern given by name ("Rotating") or number, or
+ *                "<ms> report <bytes>" to apply a raw XInput LED report
+ *                given in hex ("01 03 0A"), as captured from the USB bus.
+ *                Reports that aren't valid LED reports are ignored.
+ *                Lines starting with '#' are ignored. Commands must be in
+ *                order.
+ *
+ *                CSV output has one "ms,pattern,led1,..." row for every
+ *                change of pattern or LED state. VCD output can be opened
+ *                with any waveform viewer (e.g. GTKWave).
+ */
+
+#include "X360ControllerLEDs.h"
+#include "X360LEDReport.h"
+
+#include "Commands.h"
+
+namespace {
+
+using namespace HostTools;
+
+enum class Format { CSV, VCD };
+
+// Output that only keeps the state, which is read back with getLastFrame()
+template<uint8_t nleds>
+class Recorder : public XboxControllerLEDs_CustomStatic<Recorder<nleds>, nleds> {
+public:
+	void begin() {}
+protected:
+	void setLEDs(uint8_t ledStates) { (void) ledStates; }
+};
+
+
+// ---- Trace Output |
+
+class Trace {
+public:
+	Trace(Format f, uint8_t n) : format(f), nleds(n) {}
+
+	void header() {
+		if (format == Format::CSV) {
+			printf("ms,pattern");
+			for (uint8_t i = 0; i < nleds; i++) printf(",led%u", i + 1);
+			printf("\n");
+		}
+		else {
+			printf("$timescale 1ms $end\n");
+			printf("$scope module controller $end\n");
+			printf("$var wire 8 p pattern $end\n");
+			for (uint8_t i = 0; i < nleds; i++) printf("$var wire 1 %c led%u $end\n", 'a' + i, i + 1);
+			printf("$upscope $end\n");
+			printf("$enddefinitions $end\n");
+		}
+	}
+
+	// States at the same time are combined, so only the last one is kept
+	void update(unsigned long time, XboxLEDPattern pattern, uint8_t leds) {
+		if (pending && time != pendingTime) flush();
+		pending = true;
+		pendingTime = time;
+		pendingPattern = pattern;
+		pendingLEDs = leds;
+	}
+
+	void end(unsigned long time) {
+		flush();
+		if (format == Format::VCD) printf("#%lu\n", time);  // Length of the last state
+	}
+
+private:
+	// Writes the pending state if it differs from the last one written
+	void flush() {
+		if (!pending) return;
+		pending = false;
+
+		const unsigned long time = pendingTime;
+		const XboxLEDPattern pattern = pendingPattern;
+		const uint8_t leds = pendingLEDs;
+		if (written && pattern == lastPattern && leds == lastLEDs) return;
+
+		if (format == Format::CSV) {
+			printf("%lu,%u", time, (unsigned) pattern);
+			for (uint8_t i = 0; i < nleds; i++) printf(",%u", (leds >> i) & 1);
+			printf("\n");
+		}
+		else {
+			printf("#%lu\n", time);
+			if (!written || pattern != lastPattern) {
+				printf("b");
+				for (int8_t i = 7; i >= 0; i--) printf("%u", ((uint8_t) pattern >> i) & 1);
+				printf(" p\n");
+			}
+			for (uint8_t i = 0; i < nleds; i++) {
+				const uint8_t mask = 1 << i;
+				if (written && !((leds ^ lastLEDs) & mask)) continue;
+				printf("%u%c\n", (leds & mask) ? 1 : 0, 'a' + i);
+			}
+		}
+
+		written = true;
+		lastPattern = pattern;
+		lastLEDs = leds;
+	}
+
+	const Format format;
+	const uint8_t nleds;
+
+	boolean pending = false;
+	unsigned long pendingTime = 0;
+	XboxLEDPattern pendingPattern = XboxLEDPattern::Null;
+	uint8_t pendingLEDs = 0x00;
+
+	boolean written = false;
+	XboxLEDPattern lastPattern = XboxLEDPattern::Null;
+	uint8_t lastLEDs = 0x00;
+};
+
+
+// ---- Rendering |
+
+template<uint8_t nleds>
+void render(const std::vector<Command> & commands, unsigned long length, Trace & trace) {
+	Recorder<nleds> leds;
+
+	// Plays every frame that starts before 'time', each on its deadline
+	auto renderUntil = [&](unsigned long time) {
+		while (leds.isAnimating()) {
+			const unsigned long deadline = leds.nextDeadline();
+			if (Xbox360Controller_LEDs::XboxLEDHandlerCore::reached(deadline, time)) break;  // Starts at or after 'time'
+			ArduinoHost::setMillis(deadline);
+			leds.run(deadline);
+			trace.update(deadline, leds.getPattern(), leds.getLastFrame());
+		}
+	};
+
+	ArduinoHost::reset();
+	trace.header();
+
+	leds.setPattern(XboxLEDPattern::Off);
+	trace.update(0, leds.getPattern(), leds.getLastFrame());
+
+	for (const Command & cmd : commands) {
+		if (cmd.time >= length) break;
+		renderUntil(cmd.time + 1);  // Frames due at the same time come first
+
+		ArduinoHost::setMillis(cmd.time);
+		switch (cmd.action) {
+		case(Action::Set):
+			leds.setPattern(cmd.pattern);
+			break;
+		case(Action::Link):
+			leds.linkPattern(cmd.pattern);
+			break;
+		case(Action::Report):
+			XboxLEDReport::link(leds, cmd.report, cmd.reportLength);
+			break;
+		}
+		trace.update(cmd.time, leds.getPattern(), leds.getLastFrame());
+	}
+
+	renderUntil(length);
+	trace.end(length);
+}
+
+
+int usage() {
+	fprintf(stderr, "Usage: Render [-n 1|4] [-f csv|vcd] [-d ms] [file]\n");
+	return 2;
+}
+
+}  // End namespace
+
+int main(int argc, char * argv[]) {
+	uint8_t nleds = 4;
+	Format format = Format::CSV;
+	unsigned long length = 0;
+	boolean lengthSet = false;
+	const char * path = NULL;
+
+	for (int i = 1; i < argc; i++) {
+		const boolean hasValue = (i + 1 < argc);
+		if (strcmp(argv[i], "-n") == 0 && hasValue) {
+			nleds = (uint8_t) atoi(argv[++i]);
+			if (nleds != 1 && nleds != 4) return usage();
+		}
+		else if (strcmp(argv[i], "-f") == 0 && hasValue) {
+			const char * f = argv[++i];
+			if (strcmp(f, "csv") == 0) format = Format::CSV;
+			else if (strcmp(f, "vcd") == 0) format = Format::VCD;
+			else return usage();
+		}
+		else if (strcmp(argv[i], "-d") == 0 && hasValue) {
+			length = strtoul(argv[++i], NULL, 10);
+			lengthSet = true;
+		}
+		else if (argv[i][0] == '-' && argv[i][1] != '\0') return usage();
+		else path = argv[i];
+	}
+
+	FILE * in = stdin;
+	if (path != NULL && strcmp(path, "-") != 0) {
+		in = fopen(path, "r");
+		if (in == NULL) {
+			fprintf(stderr, "Could not open \"%s\"\n", path);
+			return 1;
+		}
+	}
+
+	std::vector<Command> commands;
+	const boolean ok = readCommands(in, commands);
+	if (in != stdin) fclose(in);
+	if (!ok) return 1;
+
+	for (const Command & cmd : commands) {
+		if (cmd.controller != 0) {
+			fprintf(stderr, "Only controller 0 can be rendered, use Replay for more\n");
+			return 1;
+		}
+	}
+
+	if (!lengthSet) length = (commands.empty() ? 0 : commands.back().time) + 10000;
+
+	Trace trace(format, nleds);
+	if (nleds == 1) render<1>(commands, length, trace);
+	else render<4>(commands, length, trace);
+
+	return 0;
+}
@@ -0,0 +1,505 @@
+/*
+ *  Project     Xbox 360 Controller LEDs Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/Xbox360ControllerLEDs
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *  Description:  Replays pattern command traces against any number of
+ *                handlers at accelerated speed and reports what the
+ *                handlers did with them: how many commands were applied,
+ *                deferred, or ignored by the handler's rules, and how long
+ *                each command took to show up on the LEDs.
+ *
+ *                Usage: Replay [-n 1|4] [-p ms] [-d ms] [file]
+ *                       Replay [-n 1|4] [-p ms] -s controllers [-t s] [-r seed] [-w]
+ *                    -n    number of LEDs / animation set (default 4)
+ *                    -p    period of the simulated 'loop()' in ms. Commands
+ *                          are queued when they arrive and applied on the
+ *                          next pass, as with XboxControllerLEDs_Queued.
+ *                          0 services every frame on its deadline
+ *                          (default 1)
+ *                    -d    length of the replay in ms (default: 10 s
+ *                          after the last command)
+ *                    -s    replay a synthetic workload for this many
+ *                          controllers instead of a file
+ *                    -t    length of the synthetic workload in seconds
+ *                          (default 600)
+ *                    -r    random seed for the synthetic workload
+ *                    -w    write the synthetic workload as a trace rather
+ *                          than replaying it
+ *                    file  trace to replay (default stdin)
+ *
+ *                Traces use the same commands as Render, with an optional
+ *                controller index after the time: "1500 3 link Player4".
+ *
+ *                A command's latency is the time from when it arrives
+ *                until the controller is running its pattern. Commands
+ *                for the pattern that will play when the current linked
+ *                animation ends (e.g. 'Player1' during 'Flash1') are
+ *                deferred until then, so these make up the tail.
+ */
+
+#include "X360ControllerLEDs.h"
+#include "X360LEDReport.h"
+
+#include "Commands.h"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <queue>
+#include <utility>
+
+namespace {
+
+using namespace HostTools;
+
+const unsigned long NoService = ~0UL;
+
+// What the handler did with a command
+enum class Outcome : uint8_t {
+	Applied,          // Pattern started
+	Deferred,         // Already the next pattern of a linked animation
+	SamePattern,      // Pattern already running
+	FlashAfterSolid,  // Player flash while the player's LEDs are solid
+	InvalidReport,    // Not an XInput LED report
+	NumOutcomes,
+};
+
+const char * const OutcomeNames[(uint8_t) Outcome::NumOutcomes] = {
+	"applied",
+	"deferred (next pattern)",
+	"ignored (same pattern)",
+	"ignored (flash after solid)",
+	"ignored (invalid report)",
+};
+
+boolean isFlash(XboxLEDPattern pattern) {
+	return pattern >= XboxLEDPattern::Flash1 && pattern <= XboxLEDPattern::Flash4;
+}
+
+boolean isPlayer(XboxLEDPattern pattern) {
+	return pattern >= XboxLEDPattern::Player1 && pattern <= XboxLEDPattern::Player4;
+}
+
+// Output that counts its writes
+template<uint8_t nleds>
+class Counter : public XboxControllerLEDs_Custom<nleds> {
+public:
+	void begin() {}
+	unsigned long writes = 0;
+protected:
+	void setLEDs(uint8_t ledStates) { (void) ledStates; writes++; }
+};
+
+
+// ---- Synthetic Workload |
+
+// Sessions modelled on what a console or PC sends to a controller:
+// connecting and player assignment (flash, then solid), re-sends of the
+// current player pattern, low battery warnings, player changes, raw
+// reports, and disconnects.
+class Workload {
+public:
+	Workload(unsigned long seed) : state((uint32_t) seed ? (uint32_t) seed : 1) {}
+
+	void generate(unsigned int controllers, unsigned long length, std::vector<Command> & commands) {
+		for (unsigned int c = 0; c < controllers; c++) session(c, length, commands);
+		std::stable_sort(commands.begin(), commands.end(),
+			[](const Command & a, const Command & b) { return a.time < b.time; });
+	}
+
+private:
+	void session(unsigned int controller, unsigned long length, std::vector<Command> & commands) {
+		uint8_t player = controller % 4;
+		unsigned long t = between(0, 5000);
+		out = &commands;
+		end = length;
+		id = controller;
+
+		t = connect(t, player);
+		while (true) {
+			t += between(2000, 30000);
+			if (t >= length) break;
+
+			const unsigned long r = between(0, 99);
+			if (r < 55) {  // Re-sends of the current pattern
+				for (unsigned long n = between(1, 3); n != 0; n--) {
+					link(t, player_(player));
+					t += between(5, 50);
+				}
+			}
+			else if (r < 70) {  // Player re-announced
+				link(t, flash(player));
+				link(t + between(10, 250), player_(player));
+			}
+			else if (r < 80) {  // Low battery warning
+				link(t, XboxLEDPattern::Blinking);
+				t += between(3000, 8000);
+				link(t, player_(player));
+			}
+			else if (r < 90) {  // New player number
+				player = (uint8_t) between(0, 3);
+				t = connect(t, player);
+			}
+			else if (r < 95) {  // Raw report, sometimes cut short
+				report(t, player_(player), between(0, 9) == 0 ? 2 : 3);
+			}
+			else {  // Disconnect and reconnect
+				add(t, Action::Set, XboxLEDPattern::Off);
+				t = connect(t + between(1000, 10000), player);
+			}
+		}
+	}
+
+	unsigned long connect(unsigned long t, uint8_t player) {
+		link(t, flash(player));
+		t += between(10, 250);
+		link(t, player_(player));
+		if (between(0, 1)) {  // Rapid re-send
+			t += between(5, 50);
+			link(t, player_(player));
+		}
+		return t;
+	}
+
+	static XboxLEDPattern flash(uint8_t player) {
+		return (XboxLEDPattern) ((uint8_t) XboxLEDPattern::Flash1 + player);
+	}
+
+	static XboxLEDPattern player_(uint8_t player) {
+		return (XboxLEDPattern) ((uint8_t) XboxLEDPattern::Player1 + player);
+	}
+
+	void link(unsigned long t, XboxLEDPattern pattern) {
+		add(t, Action::Link, pattern);
+	}
+
+	void report(unsigned long t, XboxLEDPattern pattern, uint8_t length) {
+		if (t >= end) return;
+		Command cmd = Command();
+		cmd.time = t;
+		cmd.controller = id;
+		cmd.action = Action::Report;
+		cmd.report[0] = XboxLEDReport::Type;
+		cmd.report[1] = XboxLEDReport::Length;
+		cmd.report[2] = (uint8_t) pattern;
+		cmd.reportLength = length;
+		out->push_back(cmd);
+	}
+
+	void add(unsigned long t, Action action, XboxLEDPattern pattern) {
+		if (t >= end) return;
+		Command cmd = Command();
+		cmd.time = t;
+		cmd.controller = id;
+		cmd.action = action;
+		cmd.pattern = pattern;
+		out->push_back(cmd);
+	}
+
+	unsigned long between(unsigned long lo, unsigned long hi) {
+		return lo + next() % (hi - lo + 1);
+	}
+
+	uint32_t next() {  // xorshift32
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return state;
+	}
+
+	uint32_t state;
+	std::vector<Command> * out = NULL;
+	unsigned long end = 0;
+	unsigned int id = 0;
+};
+
+
+// ---- Replay |
+
+struct Results {
+	unsigned int controllers = 0;
+	unsigned long length = 0;
+	unsigned long commands = 0;
+	unsigned long outcomes[(uint8_t) Outcome::NumOutcomes] = {};
+	unsigned long superseded = 0;  // Replaced by another command before showing
+	unsigned long outstanding = 0; // Still waiting at the end
+	unsigned long writes = 0;
+	std::vector<unsigned long> latencies;
+	double seconds = 0.0;  // Wall clock
+};
+
+template<uint8_t nleds>
+class Replay {
+public:
+	Replay(const std::vector<Command> & cmds, unsigned long p) : commands(cmds), period(p) {}
+
+	void run(unsigned long length, Results & results) {
+		unsigned int count = 0;
+		for (const Command & cmd : commands) count = std::max(count, cmd.controller + 1);
+
+		std::vector<Controller> controllers(count);
+		for (size_t i = 0; i < commands.size(); i++) {
+			controllers[commands[i].controller].commands.push_back(i);
+		}
+
+		results = Results();
+		results.controllers = count;
+		results.length = length;
+
+		const auto start = std::chrono::steady_clock::now();
+
+		ArduinoHost::reset();
+		for (Controller & c : controllers) {
+			c.leds.begin();
+			c.leds.setPattern(XboxLEDPattern::Off);
+		}
+
+		// Every controller is serviced when its next command arrives or its
+		// next frame is due, whichever is first, so idle controllers cost
+		// nothing.
+		typedef std::pair<unsigned long, unsigned int> Event;  // Time, controller
+		std::priority_queue<Event, std::vector<Event>, std::greater<Event>> events;
+		for (unsigned int i = 0; i < count; i++) {
+			const unsigned long t = nextService(controllers[i]);
+			if (t != NoService) events.push(Event(t, i));
+		}
+
+		while (!events.empty()) {
+			const Event e = events.top();
+			if (e.first >= length) break;
+			events.pop();
+
+			Controller & c = controllers[e.second];
+			service(c, e.first, results);
+			const unsigned long t = nextService(c);
+			if (t != NoService) events.push(Event(t, e.second));
+		}
+
+		for (const Controller & c : controllers) {
+			if (c.waiting) results.outstanding++;
+			results.writes += c.leds.writes;
+		}
+
+		const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		results.seconds = elapsed.count();
+	}
+
+private:
+	struct Controller {
+		Counter<nleds> leds;
+		std::vector<size_t> commands;  // Indices, in order
+		size_t next = 0;
+
+		boolean waiting = false;  // For a command's pattern to start
+		XboxLEDPattern target = XboxLEDPattern::Null;
+		unsigned long since = 0;
+	};
+
+	// The first pass of the loop at or after 't'
+	unsigned long servicedAt(unsigned long t) const {
+		if (period == 0) return t;
+		return ((t + period - 1) / period) * period;
+	}
+
+	unsigned long nextService(Controller & c) const {
+		unsigned long t = NoService;
+		if (c.next < c.commands.size()) t = commands[c.commands[c.next]].time;
+		if (c.leds.isAnimating()) t = std::min(t, c.leds.nextDeadline());
+		return t != NoService ? servicedAt(t) : NoService;
+	}
+
+	// One pass of the loop: queued commands first, then the animation
+	void service(Controller & c, unsigned long now, Results & results) {
+		ArduinoHost::setMillis(now);
+
+		while (c.next < c.commands.size()) {
+			const Command & cmd = commands[c.commands[c.next]];
+			if (cmd.time > now) break;
+			apply(c, cmd, results);
+			checkShown(c, now, results);
+			c.next++;
+		}
+
+		c.leds.run();
+		checkShown(c, now, results);
+	}
+
+	void checkShown(Controller & c, unsigned long now, Results & results) {
+		if (c.waiting && c.leds.getPattern() == c.target) {
+			results.latencies.push_back(now - c.since);
+			c.waiting = false;
+		}
+	}
+
+	void apply(Controller & c, const Command & cmd, Results & results) {
+		results.commands++;
+
+		XboxLEDPattern pattern = cmd.pattern;
+		boolean link = (cmd.action == Action::Link);
+		if (cmd.action == Action::Report) {
+			pattern = XboxLEDReport::decode(cmd.report, cmd.reportLength);
+			link = true;
+			if (pattern == XboxLEDPattern::Null) {
+				results.outcomes[(uint8_t) Outcome::InvalidReport]++;
+				return;
+			}
+		}
+
+		const XboxLEDPattern before = c.leds.getPattern();
+		if (link) c.leds.linkPattern(pattern);
+		else c.leds.setPattern(pattern);
+
+		const Outcome outcome = classify(before, c.leds.getPattern(), pattern, link);
+		results.outcomes[(uint8_t) outcome]++;
+
+		if (outcome != Outcome::Applied && outcome != Outcome::Deferred) return;
+		if (c.waiting) {
+			if (c.target == pattern) return;  // Re-sent, still timed from the first
+			results.superseded++;
+		}
+		c.waiting = true;
+		c.target = pattern;
+		c.since = cmd.time;
+	}
+
+	// Works out which of the handler's rules applied from the outside
+	static Outcome classify(XboxLEDPattern before, XboxLEDPattern after, XboxLEDPattern pattern, boolean link) {
+		if (pattern == before) return Outcome::SamePattern;
+		if (after == pattern) return Outcome::Applied;
+		if (link && isFlash(pattern) && isPlayer(before)) return Outcome::FlashAfterSolid;
+		return Outcome::Deferred;
+	}
+
+	const std::vector<Command> & commands;
+	const unsigned long period;
+};
+
+
+// ---- Report |
+
+unsigned long percentile(const std::vector<unsigned long> & sorted, double p) {
+	if (sorted.empty()) return 0;
+	size_t i = (size_t) (p / 100.0 * (sorted.size() - 1) + 0.5);
+	return sorted[i];
+}
+
+void report(Results & results) {
+	std::sort(results.latencies.begin(), results.latencies.end());
+
+	printf("Controllers:      %u\n", results.controllers);
+	printf("Replayed:         %.1f s\n", results.length / 1000.0);
+	printf("Commands:         %lu\n", results.commands);
+	for (uint8_t i = 0; i < (uint8_t) Outcome::NumOutcomes; i++) {
+		printf("  %-28s %lu\n", OutcomeNames[i], results.outcomes[i]);
+	}
+	printf("Patterns shown:   %lu (%lu superseded, %lu still waiting)\n",
+		(unsigned long) results.latencies.size(), results.superseded, results.outstanding);
+	printf("Latency (ms):     p50 %lu  p90 %lu  p99 %lu  p99.9 %lu  max %lu\n",
+		percentile(results.latencies, 50), percentile(results.latencies, 90),
+		percentile(results.latencies, 99), percentile(results.latencies, 99.9),
+		results.latencies.empty() ? 0 : results.latencies.back());
+	printf("LED writes:       %lu\n", results.writes);
+
+	const double seconds = results.seconds > 0.0 ? results.seconds : 1e-9;
+	printf("Replay time:      %.3f s (%.0fx real time, %.0f commands/s)\n",
+		results.seconds, results.length / 1000.0 / seconds, results.commands / seconds);
+}
+
+int usage() {
+	fprintf(stderr, "Usage: Replay [-n 1|4] [-p ms] [-d ms] [file]\n");
+	fprintf(stderr, "       Replay [-n 1|4] [-p ms] -s controllers [-t s] [-r seed] [-w]\n");
+	return 2;
+}
+
+}  // End namespace
+
+int main(int argc, char * argv[]) {
+	uint8_t nleds = 4;
+	unsigned long period = 1;
+	unsigned long length = 0;
+	boolean lengthSet = false;
+	unsigned long synthetic = 0;
+	unsigned long syntheticLength = 600;
+	unsigned long seed = 1;
+	boolean writeTrace = false;
+	const char * path = NULL;
+
+	for (int i = 1; i < argc; i++) {
+		const boolean hasValue = (i + 1 < argc);
+		if (strcmp(argv[i], "-n") == 0 && hasValue) {
+			nleds = (uint8_t) atoi(argv[++i]);
+			if (nleds != 1 && nleds != 4) return usage();
+		}
+		else if (strcmp(argv[i], "-p") == 0 && hasValue) period = strtoul(argv[++i], NULL, 10);
+		else if (strcmp(argv[i], "-d") == 0 && hasValue) {
+			length = strtoul(argv[++i], NULL, 10);
+			lengthSet = true;
+		}
+		else if (strcmp(argv[i], "-s") == 0 && hasValue) synthetic = strtoul(argv[++i], NULL, 10);
+		else if (strcmp(argv[i], "-t") == 0 && hasValue) syntheticLength = strtoul(argv[++i], NULL, 10);
+		else if (strcmp(argv[i], "-r") == 0 && hasValue) seed = strtoul(argv[++i], NULL, 10);
+		else if (strcmp(argv[i], "-w") == 0) writeTrace = true;
+		else if (argv[i][0] == '-' && argv[i][1] != '\0') return usage();
+		else path = argv[i];
+	}
+
+	if (writeTrace && synthetic == 0) return usage();
+
+	std::vector<Command> commands;
+	if (synthetic != 0) {
+		Workload workload(seed);
+		workload.generate((unsigned int) synthetic, syntheticLength * 1000, commands);
+
+		if (writeTrace) {
+			for (const Command & cmd : commands) writeCommand(stdout, cmd);
+			return 0;
+		}
+		if (!lengthSet) {
+			length = syntheticLength * 1000;
+			lengthSet = true;
+		}
+	}
+	else {
+		FILE * in = stdin;
+		if (path != NULL && strcmp(path, "-") != 0) {
+			in = fopen(path, "r");
+			if (in == NULL) {
+				fprintf(stderr, "Could not open \"%s\"\n", path);
+				return 1;
+			}
+		}
+
+		const boolean ok = readCommands(in, commands);
+		if (in != stdin) fclose(in);
+		if (!ok) return 1;
+	}
+
+	if (!lengthSet) length = (commands.empty() ? 0 : commands.back().time) + 10000;
+
+	Results results;
+	if (nleds == 1) Replay<1>(commands, period).run(length, results);
+	else Replay<4>(commands, period).run(length, results);
+	report(results);
+
+	return 0;
+}
@@ -28,132 +28,381 @@
 
 namespace Xbox360Controller_LEDs {
 
-static const boolean isPlayerFlash(LED_Pattern pattern) {
-	switch (pattern) {
-	case(LED_Pattern::Flash1):
-	case(LED_Pattern::Flash2):
-	case(LED_Pattern::Flash3):
-	case(LED_Pattern::Flash4):
-		return true;
-	default:
-		return false;
-	}
+// Pattern properties used when linking, one bit each
+enum PatternFlags : uint8_t {
+	Flag_PlayerFlash = (1 << 0),  // Flash 1 - 4
+	Flag_PlayerSolid = (1 << 1),  // Player 1 - 4
+};
+
+static constexpr uint8_t getFlags(LED_Pattern pattern) {
+	return
+		(pattern >= LED_Pattern::Flash1  && pattern <= LED_Pattern::Flash4)  ? Flag_PlayerFlash :
+		(pattern >= LED_Pattern::Player1 && pattern <= LED_Pattern::Player4) ? Flag_PlayerSolid :
+		0x00;
 }
 
-static const boolean isPlayerSolid(LED_Pattern pattern) {
-	switch (pattern) {
-	case(LED_Pattern::Player1):
-	case(LED_Pattern::Player2):
-	case(LED_Pattern::Player3):
-	case(LED_Pattern::Player4):
-		return true;
-	default:
-		return false;
-	}
+// Reference copies of the original switch statements, as single expressions
+// so they can be checked at compile time
+static constexpr boolean isPlayerFlash(LED_Pattern pattern) {
+	return pattern == LED_Pattern::Flash1 || pattern == LED_Pattern::Flash2
+		|| pattern == LED_Pattern::Flash3 || pattern == LED_Pattern::Flash4;
 }
 
-// Dummy animation to populate the currentAnimation pointer
-static const LED_Animation<1> Animation_Null(
-	{ LED_Frame(0, 0) },  // No LEDs lit, infinite frame duration
-	0,                    // Infinite animation repeat
-	LED_Pattern::Null     // Next animation is no animation
-);
+static constexpr boolean isPlayerSolid(LED_Pattern pattern) {
+	return pattern == LED_Pattern::Player1 || pattern == LED_Pattern::Player2
+		|| pattern == LED_Pattern::Player3 || pattern == LED_Pattern::Player4;
+}
+
+// Checks every pattern ID from 'id' up, including the meta and user patterns
+static constexpr boolean flagsMatch(unsigned int id = 0) {
+	return id > 0xFF || (
+		((getFlags((LED_Pattern) id) & Flag_PlayerFlash) != 0) == isPlayerFlash((LED_Pattern) id) &&
+		((getFlags((LED_Pattern) id) & Flag_PlayerSolid) != 0) == isPlayerSolid((LED_Pattern) id) &&
+		flagsMatch(id + 1));
+}
+
+static_assert(flagsMatch(), "Pattern flags do not match the player flash / solid patterns");
 
 //  --- LED Handler Class Base -----------------------------------------------
 
-XboxLEDHandler::XboxLEDHandler() :
+XboxLEDHandlerCore::XboxLEDHandlerCore(const LED_AnimationSet * set, boolean inv) :
+	animationSet(set),
 	currentPattern(LED_Pattern::Null),  // Not a pattern
-	previousPattern(currentPattern),
-	currentAnimation(&Xbox360Controller_LEDs::Animation_Null)
-{}
+	previousPattern(currentPattern)
+{
+	linkPatterns = false;
+	writeOutput = true;
+	outputKnown = false;
+	userFrames = false;
+	useMicros = false;
+	timing = (uint8_t) LED_Timing::Serviced;
+	linkBlocked = true;
+	animates = false;
+	inverted = inv;
+}
 
-void XboxLEDHandler::setPattern(LED_Pattern pattern) {
-	if ((uint8_t)pattern >= XboxLEDHandler::NumPatterns) return;  // Meta pattern, ignore
-	linkPatterns = false;  // Don't auto-link to the next pattern
-	setPattern(pattern, true);  // Screw it, do the pattern NOW
+LED_AnimationInfo XboxLEDHandlerCore::getAnimation(LED_Pattern pattern) const {
+	if (isUserPattern(pattern)) return userAnimations->Animations[(uint8_t) pattern - LED_UserAnimations::First];
+	if ((uint8_t)pattern >= XboxLEDHandlerCore::NumPatterns) pattern = LED_Pattern::Off;  // Meta pattern, use 'off'
+
+	const Animation * table = (const Animation *) pgm_read_ptr(&animationSet->Animations);
+	const Animation * anim = &table[(uint8_t) pattern];
+	return Animation(
+		pgm_read_byte(&anim->Offset),
+		pgm_read_byte(&anim->NFrames),
+		pgm_read_byte(&anim->NCycles),
+		(LED_Pattern) pgm_read_byte(&anim->Next)
+	);
 }
 
-void XboxLEDHandler::linkPattern(LED_Pattern pattern) {
-	if ((uint8_t)pattern >= XboxLEDHandler::NumPatterns) return;  // Meta pattern, ignore
-	linkPatterns = true;  // Auto-link to the next pattern if available
-	setPattern(pattern, false);  // Set pattern, but don't run immediately if it is next pattern in queue
+boolean XboxLEDHandlerCore::applyPattern(LED_Pattern pattern, boolean link) {
+	return applyPattern(pattern, link, getTime());
+}
+
+boolean XboxLEDHandlerCore::applyPattern(LED_Pattern pattern, boolean link, unsigned long timestamp) {
+	if ((uint8_t)pattern >= XboxLEDHandlerCore::NumPatterns && !isUserPattern(pattern)) return false;  // Meta pattern, ignore
+	linkPatterns = link;  // Auto-link to the next pattern if available
+
+	// If linking, set pattern but don't run immediately if it is next pattern in queue.
+	// Otherwise screw it, do the pattern NOW
+#ifdef XBOX_LED_STATS
+	const unsigned long changes = stats.patternChanges;
+	const boolean write = setPattern(pattern, !link, timestamp);
+	if (link && stats.patternChanges == changes) stats.ignoredLinks++;
+#else
+	const boolean write = setPattern(pattern, !link, timestamp);
+#endif
+	setAnimates(getAnimation(currentPattern));  // Linking may have changed, even if the pattern hasn't
+	return write;
+}
+
+void XboxLEDHandlerCore::setAnimates(const Animation & animation) {
+	animates = animation.NFrames > 1 || (linkPatterns && animation.NCycles != 0);
 }
 
-void XboxLEDHandler::setPattern(LED_Pattern pattern, boolean runNow) {
-	if (currentPattern == pattern) return;  // No change
-	if (runNow == false && pattern == currentAnimation->Next) return;  // That's the next pattern! We'll get there...
-	if (linkPatterns && isPlayerFlash(pattern) && isPlayerSolid(currentPattern)) return;  // Don't go back to flashing if player is solid
+boolean XboxLEDHandlerCore::setPattern(LED_Pattern pattern, boolean runNow, unsigned long timestamp) {
+	if (currentPattern == pattern) return false;  // No change
+	if (runNow == false && pattern == getAnimation(currentPattern).Next) return false;  // That's the next pattern! We'll get there...
+	if (linkPatterns && (getFlags(pattern) & Flag_PlayerFlash) && (getFlags(currentPattern) & Flag_PlayerSolid)) return false;  // Don't go back to flashing if player is solid
 
 	// If pattern says go back, load prevous pattern
 	if (pattern == LED_Pattern::Previous) {
 		pattern = previousPattern;
 	}
 
+	return startPattern(pattern, timestamp);
+}
+
+// Switches to a pattern that has already been checked (and isn't 'Previous')
+boolean XboxLEDHandlerCore::startPattern(LED_Pattern pattern, unsigned long timestamp) {
+	const boolean started = (currentPattern != LED_Pattern::Null);  // Any frames loaded yet
+	const Animation oldAnimation = getAnimation(currentPattern);
+
 	// If not currently running a temporary pattern, save as previous
-	if (currentAnimation->Next != LED_Pattern::Previous) {
+	if (oldAnimation.Next != LED_Pattern::Previous) {
 		previousPattern = currentPattern;  // Save current pattern as previous
 	}
 
 	currentPattern = pattern;  // Save pattern (enum)
+	XBOX_LED_COUNT(patternChanges);
+
+	const boolean user = isUserPattern(currentPattern);
+	const Animation animation = getAnimation(currentPattern);
+	setAnimates(animation);
+	resolveLink(animation.Next);
+	if (started && animation == oldAnimation && userFrames == user) return false;  // Different pattern, same animation
 
-	const Animation * newAnimation = &getAnimation(currentPattern);
-	if (currentAnimation == newAnimation) return;  // Different pattern, same animation
-	currentAnimation = newAnimation;  // Save animation (pointer)
+	userFrames = user;
 
 	frameIndex = 0;  // Zero frame index (start of animation frames)
 	cycleCount = 0;  // Zero cycle count (start of animation cycle)
-	runFrame();  // Run once
+	return runFrame(timestamp);  // Run once
 }
 
-void XboxLEDHandler::runFrame() {
-	const LED_Frame & frame = currentAnimation->getFrame(frameIndex);
-	time_frameDuration = frame.Duration * LED_Frame::Timescale;  // Save current frame duration as ms
-	time_frameLast = millis();  // Save time
-	lastLEDFrame = frame.LEDs;  // Save current frame
+// Works out ahead of time whether the current animation can hand off to
+// where it goes when it ends (see 'linkTarget'), with the same checks as
+// 'setPattern', so that the handoff in 'run()' is just a switch to the next
+// animation. Nothing the checks depend on can change without starting
+// another pattern (and resolving again).
+void XboxLEDHandlerCore::resolveLink(LED_Pattern next) {
+	if (next == LED_Pattern::Previous) {
+		linkBlocked = (previousPattern == currentPattern);  // No change, 'previousPattern' is the return slot
+	}
+	else {
+		linkBlocked = (next == currentPattern)  // No change
+			|| ((getFlags(next) & Flag_PlayerFlash) && (getFlags(currentPattern) & Flag_PlayerSolid));  // Don't go back to flashing if player is solid
+	}
+}
+
+boolean XboxLEDHandlerCore::runFrame(unsigned long timestamp) {
+	const LED_Frame * frame = getFrame(frameIndex);
+	if (userFrames) {
+		frameTicks = frame->Duration;  // Save current frame duration
+		lastLEDFrame = frame->LEDs;  // Save current frame
+	}
+	else {
+		frameTicks = pgm_read_word(&frame->Duration);
+		lastLEDFrame = pgm_read_byte(&frame->LEDs);
+	}
+	time_frameLast = timestamp;  // Save time
 
-	if (writeOutput) {
-		setLEDs(frame.LEDs);  // Set LEDs to current frame}
-	}	
+	return writeOutput;  // Set LEDs to current frame
 }
 
-void XboxLEDHandler::run() {
-	if (currentAnimation->getNumFrames() <= 1 || time_frameDuration == 0) return;  // No processing necessary
-	if (millis() - time_frameLast < time_frameDuration) return;  // Not time yet
+uint16_t XboxLEDHandlerCore::getFrameTicks(uint8_t index) const {
+	const LED_Frame * frame = getFrame(index);
+	return userFrames ? frame->Duration : pgm_read_word(&frame->Duration);
+}
+
+const LED_Frame * XboxLEDHandlerCore::getFrame(uint8_t index) const {
+	if (userFrames) return &userAnimations->Frames[getAnimation(currentPattern).Offset + index];
+
+	// Only the offset is needed, rather than the whole animation
+	const Animation * table = (const Animation *) pgm_read_ptr(&animationSet->Animations);
+	const LED_Frame * frames = (const LED_Frame *) pgm_read_ptr(&animationSet->Frames);
+	return &frames[pgm_read_byte(&table[(uint8_t) currentPattern].Offset) + index];
+}
 
+// Sets the pattern and moves to the frame it would be showing at 'now' if
+// it had started at 'epoch'. Without linking the animation repeats forever,
+// so the position is the time since the epoch modulo the cycle length rather
+// than every frame played in turn. Re-phases the pattern even if unchanged.
+boolean XboxLEDHandlerCore::seekPattern(LED_Pattern pattern, unsigned long epoch, unsigned long now) {
+	if ((uint8_t)pattern >= XboxLEDHandlerCore::NumPatterns && !isUserPattern(pattern)) return false;  // Meta pattern, ignore
+	if (!reached(now, epoch)) epoch = now;  // Can't start in the future
+
+	applyPattern(pattern, false, epoch);
+	const uint8_t numFrames = getAnimation(currentPattern).NFrames;
+
+	const unsigned long tick = useMicros ? LED_Frame::Timescale * 1000UL : LED_Frame::Timescale;  // Timebase units per tick
+	const uint32_t since = elapsed(now, epoch);
+	const uint32_t sinceTicks = since / tick;
+
+	uint32_t cycleTicks = 0;  // 0 if a frame holds forever, and the animation never repeats
+	for (uint8_t i = 0; i < numFrames; i++) {
+		const uint16_t ticks = getFrameTicks(i);
+		if (ticks == 0) {
+			cycleTicks = 0;
+			break;
+		}
+		cycleTicks += ticks;
+	}
+	const uint32_t position = (cycleTicks != 0) ? sinceTicks % cycleTicks : sinceTicks;  // Ticks into the cycle
+
+	uint32_t frameStart = 0;  // Ticks into the cycle
+	uint8_t index = 0;
+	for (; index < numFrames - 1; index++) {
+		const uint16_t ticks = getFrameTicks(index);
+		if (ticks == 0 || frameStart + ticks > position) break;
+		frameStart += ticks;
+	}
+
+	frameIndex = index;
+	cycleCount = (cycleTicks != 0) ? (uint8_t) (sinceTicks / cycleTicks) : 0;
+	return runFrame(now - ((position - frameStart) * tick + since % tick));  // Back to where the frame started
+}
+
+boolean XboxLEDHandlerCore::advanceFrame(unsigned long now) {
+	if (!frameDue(now)) return false;  // Not time yet
+	recordLateness(now);
+	return nextFrame(now);
+}
+
+boolean XboxLEDHandlerCore::advanceTo(unsigned long now) {
+	boolean write = false;
+	while (frameDue(now)) {
+		const uint32_t deadline = frameDeadline();
+		recordLateness(now);
+		if (nextFrame(deadline)) write = true;  // Only the last frame is visible, but any may need writing
+		if (time_frameLast != deadline) break;  // Linked to an animation that's already running, no new frame
+	}
+	return write;
+}
+
+boolean XboxLEDHandlerCore::advance(unsigned long now) {
+	switch ((LED_Timing) timing) {
+	case(LED_Timing::CatchUp):
+		if (!frameDue(now)) return false;
+		recordLateness(now);
+		return nextFrame(frameDeadline());  // One frame, starting at its deadline
+	case(LED_Timing::Skip):
+		return advanceTo(now);
+	default:
+		return advanceFrame(now);
+	}
+}
+
+boolean XboxLEDHandlerCore::nextFrame(unsigned long timestamp) {
+	const Animation animation = getAnimation(currentPattern);
 	frameIndex++;  // Go to next frame
-	if (frameIndex >= currentAnimation->getNumFrames()) {  // End of animation cycle
+	if (frameIndex >= animation.NFrames) {  // End of animation cycle
 		cycleCount++;  // Increase animation cycle counter (linking can be enabled at any point)
 		// If linking enabled AND animation has an ending AN we're *at* that ending...
-		if (linkPatterns && currentAnimation->NCycles != 0 && cycleCount >= currentAnimation->NCycles) {
-				setPattern(currentAnimation->Next, true);    // Run next pattern + override "Next" check
-			return;
+		if (linkPatterns && animation.NCycles != 0 && cycleCount >= animation.NCycles) {
+			if (linkBlocked) {  // Can't switch, hold the last frame until the pattern is changed
+				frameIndex = animation.NFrames - 1;
+				frameTicks = 0;
+				return false;
+			}
+			XBOX_LED_COUNT(linkedChanges);
+			return startPattern(linkTarget(animation.Next), timestamp);  // Run next pattern, checked when this one started
 		}
 		frameIndex = 0;  // If at last frame, go to start
 	}
-	runFrame();  // Write current frame to LEDs
+	return runFrame(timestamp);  // Write current frame to LEDs
 }
 
-void XboxLEDHandler::pauseOutput() {
-	writeOutput = false;
+void XboxLEDHandlerCore::recordLateness(unsigned long now) {
+#ifdef XBOX_LED_STATS
+	const unsigned long late = elapsed(now, frameDeadline());
+	stats.frames++;
+	if (late != 0) stats.lateFrames++;
+	if (late > stats.latenessMax) stats.latenessMax = late;
+	stats.latenessTotal += late;
+#else
+	(void) now;
+#endif
 }
 
-void XboxLEDHandler::resumeOutput() {
-	if (writeOutput == false) {
-		writeOutput = true;
-		rewriteFrame();  // If unpausing, rewrite current LED frame
-	}
+#ifdef XBOX_LED_STATS
+LED_Stats XboxLEDHandlerCore::getStats() const {
+	XboxLED_InterruptLock lock;
+	return stats;
+}
+
+void XboxLEDHandlerCore::resetStats() {
+	XboxLED_InterruptLock lock;
+	stats = LED_Stats();
 }
+#endif
 
-LED_Pattern XboxLEDHandler::getPattern() const {
+boolean XboxLEDHandlerCore::setOutput(boolean enable) {
+	const boolean resumed = (enable && !writeOutput);
+	writeOutput = enable;
+	if (!enable) outputKnown = false;  // The LEDs may be changed by someone else while paused
+	return resumed;  // If unpausing, rewrite current LED frame
+}
+
+uint8_t XboxLEDHandlerCore::takeOutputChanges(boolean force) {
+	const uint8_t changed = (force || !outputKnown) ? 0xFF : (uint8_t) (lastLEDFrame ^ outputLEDs);
+	outputLEDs = lastLEDFrame;
+	outputKnown = writeOutput;  // A rewrite while paused may still be overwritten, see 'setOutput'
+	return changed;
+}
+
+void XboxLEDHandlerCore::setTiming(LED_Timing policy, boolean precise) {
+	timing = (uint8_t) policy;
+	if (precise == useMicros) return;
+
+	useMicros = precise;
+	if (currentPattern != LED_Pattern::Null) runFrame(getTime());  // Restart the frame in the new timebase
+}
+
+unsigned long XboxLEDHandlerCore::nextDeadline() const {
+	if (!isAnimating()) return NoDeadline;  // Frame never changes
+	return frameDeadline();
+}
+
+unsigned long XboxLEDHandlerCore::timeToNextFrame(unsigned long now) const {
+	if (!isAnimating()) return NoDeadline;  // Frame never changes
+
+	const uint32_t since = elapsed(now, time_frameLast);
+	const unsigned long duration = frameDuration();
+	if (since >= duration) return 0;  // Due now
+	return duration - since;
+}
+
+LED_Pattern XboxLEDHandlerCore::getPattern() const {
 	return currentPattern;  // Current pattern as enum
 }
 
-uint8_t XboxLEDHandler::getLastFrame() const {
+uint8_t XboxLEDHandlerCore::getLastFrame() const {
 	return lastLEDFrame;
 }
 
+
+//  --- LED Handler Class (Virtual Output) -----------------------------------
+
+XboxLEDHandler::XboxLEDHandler(const LED_AnimationSet * set, boolean inv) :
+	XboxLEDHandlerCore(set, inv)
+{}
+
+void XboxLEDHandler::setPattern(LED_Pattern pattern) {
+	if (applyPattern(pattern, false)) writeFrame();
+}
+
+void XboxLEDHandler::linkPattern(LED_Pattern pattern) {
+	if (applyPattern(pattern, true)) writeFrame();
+}
+
+void XboxLEDHandler::run() {
+	XBOX_LED_COUNT(runs);
+	if (isAnimating() && advance(getTime())) writeFrame();
+}
+
+void XboxLEDHandler::run(unsigned long now) {
+	XBOX_LED_COUNT(runs);
+	if (advanceTo(now)) writeFrame();
+}
+
+void XboxLEDHandler::pauseOutput() {
+	setOutput(false);
+}
+
+void XboxLEDHandler::resumeOutput() {
+	if (setOutput(true)) writeFrame();
+}
+
 void XboxLEDHandler::rewriteFrame() {
-	setLEDs(lastLEDFrame);  // Re-output with last LED data
+	XBOX_LED_COUNT(writes);
+	updateLEDs(getLastFrame(), takeOutputChanges(true));  // Re-output with last LED data
+}
+
+void XboxLEDHandler::writeFrame() {
+	const uint8_t changed = takeOutputChanges();
+	if (changed == 0) return;  // Already showing this frame
+	XBOX_LED_COUNT(writes);
+	updateLEDs(getLastFrame(), changed);
 }
 
 
@@ -162,108 +411,74 @@ void XboxLEDHandler::rewriteFrame() {
 constexpr uint8_t XboxLEDAnimations<1>::On;
 constexpr uint8_t XboxLEDAnimations<1>::Off;
 
-const LED_Animation<1> XboxLEDAnimations<1>::Anim_Off({
-	LED_Frame(XboxLEDAnimations<1>::Off, 0)
-});
+const LED_Frame XboxLEDAnimations<1>::Frames[] PROGMEM = {
+	// Off
+	LED_Frame(XboxLEDAnimations<1>::Off, 0),
 
-const LED_Animation<2> XboxLEDAnimations<1>::Anim_Blinking({
+	// Blinking
 	LED_Frame(XboxLEDAnimations<1>::Off, XboxLEDAnimations<1>::BlinkTime),
 	LED_Frame(XboxLEDAnimations<1>::On,  XboxLEDAnimations<1>::BlinkTime),
-});
 
-const LED_Animation<2> XboxLEDAnimations<1>::Anim_Flash1({
+	// Flash (1 - 4)
 	LED_Frame(XboxLEDAnimations<1>::Off, XboxLEDAnimations<1>::FlashTime),
-	LED_Frame(XboxLEDAnimations<1>::On,  XboxLEDAnimations<1>::FlashTime)},
-	PlayerFlashCount,
-	LED_Pattern::Player1  // After flashing, go to Player 1
-);
+	LED_Frame(XboxLEDAnimations<1>::On,  XboxLEDAnimations<1>::FlashTime),
 
-const LED_Animation<2> XboxLEDAnimations<1>::Anim_Flash2({
-	LED_Frame(XboxLEDAnimations<1>::Off, XboxLEDAnimations<1>::FlashTime),
-	LED_Frame(XboxLEDAnimations<1>::On,  XboxLEDAnimations<1>::FlashTime)},
-	PlayerFlashCount,
-	LED_Pattern::Player2  // After flashing, go to Player 2
-);
-
-const LED_Animation<2> XboxLEDAnimations<1>::Anim_Flash3({
-	LED_Frame(XboxLEDAnimations<1>::Off, XboxLEDAnimations<1>::FlashTime),
-	LED_Frame(XboxLEDAnimations<1>::On,  XboxLEDAnimations<1>::FlashTime)},
-	PlayerFlashCount,
-	LED_Pattern::Player3  // After flashing, go to Player 3
-);
-
-const LED_Animation<2> XboxLEDAnimations<1>::Anim_Flash4({
-	LED_Frame(XboxLEDAnimations<1>::Off, XboxLEDAnimations<1>::FlashTime),
-	LED_Frame(XboxLEDAnimations<1>::On,  XboxLEDAnimations<1>::FlashTime)},
-	PlayerFlashCount,
-	LED_Pattern::Player4  // After flashing, go to Player 4
-);
-
-const LED_Animation<1> XboxLEDAnimations<1>::Anim_Player1({
+	// Player 1
 	LED_Frame(XboxLEDAnimations<1>::On, 0),  // Always on, usual mode. Non-distracting.
-});
 
-const LED_Animation<4> XboxLEDAnimations<1>::Anim_Player2({
-	// Flash 1
-	LED_Frame(XboxLEDAnimations<1>::Off, PlayerTime + PlayerLoopTime),
+	// Player 2
+	LED_Frame(XboxLEDAnimations<1>::Off, PlayerTime + PlayerLoopTime),  // Flash 1
 	LED_Frame(XboxLEDAnimations<1>::On,  PlayerTime),
-
-	// Flash 2
-	LED_Frame(XboxLEDAnimations<1>::Off, PlayerTime),
+	LED_Frame(XboxLEDAnimations<1>::Off, PlayerTime),  // Flash 2
 	LED_Frame(XboxLEDAnimations<1>::On,  PlayerTime),
-});
 
-const LED_Animation<6> XboxLEDAnimations<1>::Anim_Player3({
-	// Flash 1
-	LED_Frame(XboxLEDAnimations<1>::Off, PlayerTime + PlayerLoopTime),
+	// Player 3
+	LED_Frame(XboxLEDAnimations<1>::Off, PlayerTime + PlayerLoopTime),  // Flash 1
 	LED_Frame(XboxLEDAnimations<1>::On,  PlayerTime),
-
-	// Flash 2
-	LED_Frame(XboxLEDAnimations<1>::Off, PlayerTime),
+	LED_Frame(XboxLEDAnimations<1>::Off, PlayerTime),  // Flash 2
 	LED_Frame(XboxLEDAnimations<1>::On,  PlayerTime),
-
-	// Flash 3
-	LED_Frame(XboxLEDAnimations<1>::Off, PlayerTime),
+	LED_Frame(XboxLEDAnimations<1>::Off, PlayerTime),  // Flash 3
 	LED_Frame(XboxLEDAnimations<1>::On,  PlayerTime),
-});
 
-const LED_Animation<8> XboxLEDAnimations<1>::Anim_Player4({
-	// Flash 1
-	LED_Frame(XboxLEDAnimations<1>::Off, PlayerTime + PlayerLoopTime),
+	// Player 4
+	LED_Frame(XboxLEDAnimations<1>::Off, PlayerTime + PlayerLoopTime),  // Flash 1
 	LED_Frame(XboxLEDAnimations<1>::On,  PlayerTime),
-
-	// Flash 2
-	LED_Frame(XboxLEDAnimations<1>::Off, PlayerTime),
+	LED_Frame(XboxLEDAnimations<1>::Off, PlayerTime),  // Flash 2
 	LED_Frame(XboxLEDAnimations<1>::On,  PlayerTime),
-
-	// Flash 3
-	LED_Frame(XboxLEDAnimations<1>::Off, PlayerTime),
+	LED_Frame(XboxLEDAnimations<1>::Off, PlayerTime),  // Flash 3
 	LED_Frame(XboxLEDAnimations<1>::On,  PlayerTime),
-
-	// Flash 4
-	LED_Frame(XboxLEDAnimations<1>::Off, PlayerTime),
+	LED_Frame(XboxLEDAnimations<1>::Off, PlayerTime),  // Flash 4
 	LED_Frame(XboxLEDAnimations<1>::On,  PlayerTime),
-});
-
-const AnimationBase & XboxLEDAnimations<1>::getAnimation(LED_Pattern pattern) {
-	switch (pattern) {
-	case(LED_Pattern::Off):         return Anim_Off;
-	case(LED_Pattern::Blinking):    return Anim_Blinking;
-	case(LED_Pattern::Flash1):      return Anim_Flash1;
-	case(LED_Pattern::Flash2):      return Anim_Flash2;
-	case(LED_Pattern::Flash3):      return Anim_Flash3;
-	case(LED_Pattern::Flash4):      return Anim_Flash4;
-	case(LED_Pattern::Player1):     return Anim_Player1;
-	case(LED_Pattern::Player2):     return Anim_Player2;
-	case(LED_Pattern::Player3):     return Anim_Player3;
-	case(LED_Pattern::Player4):     return Anim_Player4;
-	case(LED_Pattern::Rotating):    // Intentionally
-	case(LED_Pattern::BlinkOnce):   // Fall
-	case(LED_Pattern::BlinkSlow):   // Through Cases
-	case(LED_Pattern::Alternating): return Anim_Blinking;
-	default: return Anim_Off;
-	}
-}
+};
+
+static_assert(sizeof(XboxLEDAnimations<1>::Frames) / sizeof(LED_Frame) == XboxLEDAnimations<1>::Frames_End,
+	"1 LED frame table does not match its layout");
+
+// Indexed by pattern: first frame, # of frames, # of cycles, next pattern
+const LED_AnimationInfo XboxLEDAnimations<1>::Animations[] PROGMEM = {
+	LED_AnimationInfo(Frames_Off,      1),  // Off
+	LED_AnimationInfo(Frames_Blinking, 2),  // Blinking
+
+	LED_AnimationInfo(Frames_Flash, 2, PlayerFlashCount, LED_Pattern::Player1),  // Flash 1, then Player 1
+	LED_AnimationInfo(Frames_Flash, 2, PlayerFlashCount, LED_Pattern::Player2),  // Flash 2, then Player 2
+	LED_AnimationInfo(Frames_Flash, 2, PlayerFlashCount, LED_Pattern::Player3),  // Flash 3, then Player 3
+	LED_AnimationInfo(Frames_Flash, 2, PlayerFlashCount, LED_Pattern::Player4),  // Flash 4, then Player 4
+
+	LED_AnimationInfo(Frames_Player1, 1),  // Player 1
+	LED_AnimationInfo(Frames_Player2, 4),  // Player 2
+	LED_AnimationInfo(Frames_Player3, 6),  // Player 3
+	LED_AnimationInfo(Frames_Player4, 8),  // Player 4
+
+	LED_AnimationInfo(Frames_Blinking, 2),  // Rotating    (uses 'Blinking')
+	LED_AnimationInfo(Frames_Blinking, 2),  // BlinkOnce   (uses 'Blinking')
+	LED_AnimationInfo(Frames_Blinking, 2),  // BlinkSlow   (uses 'Blinking')
+	LED_AnimationInfo(Frames_Blinking, 2),  // Alternating (uses 'Blinking')
+};
+
+static_assert(sizeof(XboxLEDAnimations<1>::Animations) / sizeof(LED_AnimationInfo) == XboxLEDHandlerCore::NumPatterns,
+	"1 LED animation table must have one entry per pattern");
+
+const LED_AnimationSet XboxLEDAnimations<1>::Set PROGMEM = { Frames, Animations };
 
 //  --- 4 LED Animations -----------------------------------------------------
 
@@ -278,109 +493,78 @@ constexpr uint8_t XboxLEDAnimations<4>::States_Player4;
 constexpr uint8_t XboxLEDAnimations<4>::States_Op1;
 constexpr uint8_t XboxLEDAnimations<4>::States_Op2;
 
-const LED_Animation<1> XboxLEDAnimations<4>::Anim_Off ({ 
-	LED_Frame(XboxLEDAnimations<4>::States_Off, 0)
-});
+const LED_Frame XboxLEDAnimations<4>::Frames[] PROGMEM = {
+	// Off
+	LED_Frame(XboxLEDAnimations<4>::States_Off, 0),
 
-const LED_Animation<2> XboxLEDAnimations<4>::Anim_Blinking({
+	// Blinking
 	LED_Frame(XboxLEDAnimations<4>::States_Off, XboxLEDAnimations<4>::BlinkTime),
-	LED_Frame(XboxLEDAnimations<4>::States_On,  XboxLEDAnimations<4>::BlinkTime)},
-	4,   // Blink 4 times
-	LED_Pattern::BlinkSlow  // After blinking fast, blink slow
-);
-
-const LED_Animation<2> XboxLEDAnimations<4>::Anim_BlinkOnce({
-	LED_Frame(XboxLEDAnimations<4>::States_Off, XboxLEDAnimations<4>::BlinkSlow),
-	LED_Frame(XboxLEDAnimations<4>::States_On,  XboxLEDAnimations<4>::BlinkTime)},
-	1, // Blink once
-	LED_Pattern::Previous  // After blinking, go back to previous
-);
+	LED_Frame(XboxLEDAnimations<4>::States_On,  XboxLEDAnimations<4>::BlinkTime),
 
-const LED_Animation<2> XboxLEDAnimations<4>::Anim_BlinkSlow({
+	// BlinkSlow / BlinkOnce
 	LED_Frame(XboxLEDAnimations<4>::States_Off, XboxLEDAnimations<4>::BlinkSlow),
-	LED_Frame(XboxLEDAnimations<4>::States_On,  XboxLEDAnimations<4>::BlinkTime)},
-	16,   // Blink 16 times
-	LED_Pattern::Previous  // After blinking slow, go back to previous
-);
+	LED_Frame(XboxLEDAnimations<4>::States_On,  XboxLEDAnimations<4>::BlinkTime),
 
-const LED_Animation<2> XboxLEDAnimations<4>::Anim_Flash1({
+	// Flash 1
 	LED_Frame(XboxLEDAnimations<4>::States_Off,     XboxLEDAnimations<4>::BlinkTime),
-	LED_Frame(XboxLEDAnimations<4>::States_Player1, XboxLEDAnimations<4>::BlinkTime)},
-	PlayerBlinkCount,  // Flash n times
-	LED_Pattern::Player1  // After flashing, go to Player 1
-);
+	LED_Frame(XboxLEDAnimations<4>::States_Player1, XboxLEDAnimations<4>::BlinkTime),
 
-const LED_Animation<2> XboxLEDAnimations<4>::Anim_Flash2({
+	// Flash 2
 	LED_Frame(XboxLEDAnimations<4>::States_Off,     XboxLEDAnimations<4>::BlinkTime),
-	LED_Frame(XboxLEDAnimations<4>::States_Player2, XboxLEDAnimations<4>::BlinkTime)},
-	PlayerBlinkCount,  // Flash n times
-	LED_Pattern::Player2  // After flashing, go to Player 2
-);
+	LED_Frame(XboxLEDAnimations<4>::States_Player2, XboxLEDAnimations<4>::BlinkTime),
 
-const LED_Animation<2> XboxLEDAnimations<4>::Anim_Flash3 ({
+	// Flash 3
 	LED_Frame(XboxLEDAnimations<4>::States_Off,     XboxLEDAnimations<4>::BlinkTime),
-	LED_Frame(XboxLEDAnimations<4>::States_Player3, XboxLEDAnimations<4>::BlinkTime)},
-	PlayerBlinkCount,  // Flash n times
-	LED_Pattern::Player3  // After flashing, go to Player 3
-);
+	LED_Frame(XboxLEDAnimations<4>::States_Player3, XboxLEDAnimations<4>::BlinkTime),
 
-const LED_Animation<2> XboxLEDAnimations<4>::Anim_Flash4({
+	// Flash 4
 	LED_Frame(XboxLEDAnimations<4>::States_Off,     XboxLEDAnimations<4>::BlinkTime),
-	LED_Frame(XboxLEDAnimations<4>::States_Player4, XboxLEDAnimations<4>::BlinkTime)},
-	PlayerBlinkCount,  // Flash n times
-	LED_Pattern::Player4  // After flashing, go to Player 4
-);
+	LED_Frame(XboxLEDAnimations<4>::States_Player4, XboxLEDAnimations<4>::BlinkTime),
 
-const LED_Animation<1> XboxLEDAnimations<4>::Anim_Player1 ({
+	// Player 1 - 4
 	LED_Frame(XboxLEDAnimations<4>::States_Player1, 0),
-});
-
-const LED_Animation<1> XboxLEDAnimations<4>::Anim_Player2 ({
 	LED_Frame(XboxLEDAnimations<4>::States_Player2, 0),
-});
-
-const LED_Animation<1> XboxLEDAnimations<4>::Anim_Player3 ({
 	LED_Frame(XboxLEDAnimations<4>::States_Player3, 0),
-});
-
-const LED_Animation<1> XboxLEDAnimations<4>::Anim_Player4 ({
 	LED_Frame(XboxLEDAnimations<4>::States_Player4, 0),
-});
 
-const LED_Animation<4> XboxLEDAnimations<4>::Anim_Rotating ({
+	// Rotating
 	LED_Frame(XboxLEDAnimations<4>::States_Player1, XboxLEDAnimations<4>::RotateTime),
 	LED_Frame(XboxLEDAnimations<4>::States_Player2, XboxLEDAnimations<4>::RotateTime),
 	LED_Frame(XboxLEDAnimations<4>::States_Player4, XboxLEDAnimations<4>::RotateTime),
-	LED_Frame(XboxLEDAnimations<4>::States_Player3, XboxLEDAnimations<4>::RotateTime)},
-	50,  // Rotate 50 times
-	LED_Pattern::Previous  // After rotating, go back to previous
-);
+	LED_Frame(XboxLEDAnimations<4>::States_Player3, XboxLEDAnimations<4>::RotateTime),
 
-const LED_Animation<2> XboxLEDAnimations<4>::Anim_Alternating ({
+	// Alternating
 	LED_Frame(XboxLEDAnimations<4>::States_Op1, XboxLEDAnimations<4>::BlinkTime),
-	LED_Frame(XboxLEDAnimations<4>::States_Op2, XboxLEDAnimations<4>::BlinkTime)},
-	7,  // Alternate 7 times
-	LED_Pattern::Previous  // After alternating, go back to previous
-);
-
-const AnimationBase & XboxLEDAnimations<4>::getAnimation(LED_Pattern pattern) {
-	switch (pattern) {
-	case(LED_Pattern::Off):         return Anim_Off;
-	case(LED_Pattern::Blinking):    return Anim_Blinking;
-	case(LED_Pattern::Flash1):      return Anim_Flash1;
-	case(LED_Pattern::Flash2):      return Anim_Flash2;
-	case(LED_Pattern::Flash3):      return Anim_Flash3;
-	case(LED_Pattern::Flash4):      return Anim_Flash4;
-	case(LED_Pattern::Player1):     return Anim_Player1;
-	case(LED_Pattern::Player2):     return Anim_Player2;
-	case(LED_Pattern::Player3):     return Anim_Player3;
-	case(LED_Pattern::Player4):     return Anim_Player4;
-	case(LED_Pattern::Rotating):    return Anim_Rotating;
-	case(LED_Pattern::BlinkOnce):   return Anim_BlinkOnce;
-	case(LED_Pattern::BlinkSlow):   return Anim_BlinkSlow;
-	case(LED_Pattern::Alternating): return Anim_Alternating;
-	default: return Anim_Off;
-	}
-}
+	LED_Frame(XboxLEDAnimations<4>::States_Op2, XboxLEDAnimations<4>::BlinkTime),
+};
+
+static_assert(sizeof(XboxLEDAnimations<4>::Frames) / sizeof(LED_Frame) == XboxLEDAnimations<4>::Frames_End,
+	"4 LED frame table does not match its layout");
+
+// Indexed by pattern: first frame, # of frames, # of cycles, next pattern
+const LED_AnimationInfo XboxLEDAnimations<4>::Animations[] PROGMEM = {
+	LED_AnimationInfo(Frames_Off, 1),  // Off
+	LED_AnimationInfo(Frames_Blinking, 2, 4, LED_Pattern::BlinkSlow),  // Blink 4 times, then blink slow
+
+	LED_AnimationInfo(Frames_Flash1, 2, PlayerBlinkCount, LED_Pattern::Player1),  // Flash n times, then Player 1
+	LED_AnimationInfo(Frames_Flash2, 2, PlayerBlinkCount, LED_Pattern::Player2),  // Flash n times, then Player 2
+	LED_AnimationInfo(Frames_Flash3, 2, PlayerBlinkCount, LED_Pattern::Player3),  // Flash n times, then Player 3
+	LED_AnimationInfo(Frames_Flash4, 2, PlayerBlinkCount, LED_Pattern::Player4),  // Flash n times, then Player 4
+
+	LED_AnimationInfo(Frames_Player1, 1),  // Player 1
+	LED_AnimationInfo(Frames_Player2, 1),  // Player 2
+	LED_AnimationInfo(Frames_Player3, 1),  // Player 3
+	LED_AnimationInfo(Frames_Player4, 1),  // Player 4
+
+	LED_AnimationInfo(Frames_Rotating,    4, 50, LED_Pattern::Previous),  // Rotate 50 times, then go back
+	LED_AnimationInfo(Frames_BlinkSlow,   2,  1, LED_Pattern::Previous),  // BlinkOnce, then go back
+	LED_AnimationInfo(Frames_BlinkSlow,   2, 16, LED_Pattern::Previous),  // BlinkSlow 16 times, then go back
+	LED_AnimationInfo(Frames_Alternating, 2,  7, LED_Pattern::Previous),  // Alternate 7 times, then go back
+};
+
+static_assert(sizeof(XboxLEDAnimations<4>::Animations) / sizeof(LED_AnimationInfo) == XboxLEDHandlerCore::NumPatterns,
+	"4 LED animation table must have one entry per pattern");
+
+const LED_AnimationSet XboxLEDAnimations<4>::Set PROGMEM = { Frames, Animations };
 
 }  // End Namespace
@@ -29,6 +29,15 @@
 
 #include <Arduino.h>
 
+// Define XBOX_LED_STATS to keep timing statistics for each handler (see
+// LED_Stats below). It must be defined for the whole build (e.g. as a
+// compiler flag), not just in the sketch, so that the library sees it too.
+#ifdef XBOX_LED_STATS
+	#define XBOX_LED_COUNT(counter) (stats.counter++)
+#else
+	#define XBOX_LED_COUNT(counter)
+#endif
+
 namespace Xbox360Controller_LEDs {
 
 	/* 
@@ -69,54 +78,72 @@ namespace Xbox360Controller_LEDs {
 	struct LED_Frame {
 		static const unsigned long Timescale = 10;  // x ms = 1 tick
 
+		constexpr LED_Frame() : LEDs(0), Duration(0) {}
+
 		constexpr LED_Frame(const uint8_t LED_Pack, const unsigned long length) :
 			LEDs(LED_Pack),
 			Duration(length / Timescale)  // Converts ms to # of ticks
 		{}
 
-		const uint8_t LEDs;  // Packed byte, 8 LED states max
-		const uint8_t Duration;  // In ticks (see timescale above)
+		uint8_t LEDs;  // Packed byte, 8 LED states max
+		uint16_t Duration;  // In ticks (see timescale above), up to ~10 minutes
 	};
 
-	class AnimationBase {
-	public:
-		constexpr AnimationBase(uint8_t n, LED_Pattern nxt)
-			: NCycles(n), Next(nxt)
+	struct LED_AnimationInfo {
+		constexpr LED_AnimationInfo() :
+			Offset(0), NFrames(0), NCycles(0), Next(LED_Pattern::Null)
 		{}
 
-		virtual LED_Frame getFrame(size_t n) const = 0;
-		virtual size_t getNumFrames() const = 0;
+		constexpr LED_AnimationInfo(uint8_t offset, uint8_t nframes,
+			uint8_t ncycles = 0, LED_Pattern nxt = LED_Pattern::Null) :
+			Offset(offset), NFrames(nframes), NCycles(ncycles), Next(nxt)
+		{}
+
+		boolean operator==(const LED_AnimationInfo & other) const {
+			return Offset == other.Offset && NFrames == other.NFrames
+				&& NCycles == other.NCycles && Next == other.Next;
+		}
 
-		const uint8_t NCycles;   // How long to run this pattern, # of cycles
-		const LED_Pattern Next;  // Next pattern to run
+		uint8_t Offset;   // Index of the first frame in the animation's frame table
+		uint8_t NFrames;  // # of frames in the animation
+		uint8_t NCycles;  // How long to run this pattern, # of cycles (0 = forever)
+		LED_Pattern Next; // Next pattern to run
 	};
 
-	template<size_t nframes>
-	class LED_Animation : public AnimationBase {
-	public:
-		constexpr LED_Animation(LED_Frame const (&Array)[nframes],
-			unsigned long t = 0, LED_Pattern nxt = LED_Pattern::Null)
-			: AnimationBase(t, nxt), Frames(Array)
-		{}
+	// Where an animation set's tables are. Stored in flash itself, so a
+	// handler keeps a single pointer to find both tables.
+	struct LED_AnimationSet {
+		const LED_Frame * Frames;
+		const LED_AnimationInfo * Animations;
+	};
 
-		using AnimationBase::getFrame;
-		using AnimationBase::getNumFrames;
+	// Animations loaded at runtime, in RAM. Played with the
+	// pattern IDs starting at 'First' (see X360LEDRegistry.h).
+	struct LED_UserAnimations {
+		static const uint8_t First = 0x40;  // Pattern ID of the first user animation
+		static const uint8_t Max = 0x40;    // IDs 0x40 - 0x7F
 
-		LED_Frame getFrame(size_t n) const {
-			return Frames[n];
-		}
+		const LED_Frame * Frames;
+		const LED_AnimationInfo * Animations;
+		uint8_t Count;  // # of animations
+	};
 
-		size_t getNumFrames() const {
-			return nframes;
-		}
+	// Compile-time 'condition ? A : B' for types, used by the
+	// sequence builder and the wide frame word
+	template <boolean condition, class A, class B>
+	struct LED_Select { using type = A; };
 
-	private:
-		const LED_Frame Frames[nframes];
-	};
+	template <class A, class B>
+	struct LED_Select<false, A, B> { using type = B; };
 
 	// --------------------------------------------------------
 	// Animation Lists                                        |
-	//     All of the animations for a given # of LEDs        |
+	//     All of the animations for a given # of LEDs.       |
+	//     Frames are stored in flash as one contiguous       |
+	//     table, and each pattern has an entry in the        |
+	//     'Animations' table (indexed by pattern) pointing   |
+	//     to its frames. 'Set' points to both tables and is  |
+	//     what the handlers are given.                       |
 	// --------------------------------------------------------
 
 	template <size_t nleds>
@@ -132,20 +159,21 @@ namespace Xbox360Controller_LEDs {
 	template <>
 	class XboxLEDAnimations<1> {
 	public:
-		static const LED_Animation<1> Anim_Off;
-		static const LED_Animation<2> Anim_Blinking;
-
-		static const LED_Animation<2> Anim_Flash1;
-		static const LED_Animation<2> Anim_Flash2;
-		static const LED_Animation<2> Anim_Flash3;
-		static const LED_Animation<2> Anim_Flash4;
-
-		static const LED_Animation<1> Anim_Player1;
-		static const LED_Animation<4> Anim_Player2;
-		static const LED_Animation<6> Anim_Player3;
-		static const LED_Animation<8> Anim_Player4;
-
-		static const AnimationBase & getAnimation(LED_Pattern pattern);
+		static const LED_Frame Frames[] PROGMEM;
+		static const LED_AnimationInfo Animations[] PROGMEM;
+		static const LED_AnimationSet Set PROGMEM;
+
+		// Frame table layout, index of the first frame for each animation
+		enum FrameIndex : uint8_t {
+			Frames_Off      = 0,
+			Frames_Blinking = Frames_Off + 1,
+			Frames_Flash    = Frames_Blinking + 2,  // Shared by Flash1-4
+			Frames_Player1  = Frames_Flash + 2,
+			Frames_Player2  = Frames_Player1 + 1,
+			Frames_Player3  = Frames_Player2 + 4,
+			Frames_Player4  = Frames_Player3 + 6,
+			Frames_End      = Frames_Player4 + 8,
+		};
 
 	protected:
 		static constexpr uint32_t BlinkTime = 450;
@@ -163,25 +191,27 @@ namespace Xbox360Controller_LEDs {
 	template <>
 	class XboxLEDAnimations<4> {
 	public:
-		static const LED_Animation<1> Anim_Off;
-		static const LED_Animation<2> Anim_Blinking;
-		static const LED_Animation<2> Anim_BlinkOnce;
-		static const LED_Animation<2> Anim_BlinkSlow;
-
-		static const LED_Animation<2> Anim_Flash1;
-		static const LED_Animation<2> Anim_Flash2;
-		static const LED_Animation<2> Anim_Flash3;
-		static const LED_Animation<2> Anim_Flash4;
-
-		static const LED_Animation<1> Anim_Player1;
-		static const LED_Animation<1> Anim_Player2;
-		static const LED_Animation<1> Anim_Player3;
-		static const LED_Animation<1> Anim_Player4;
-
-		static const LED_Animation<4> Anim_Rotating;
-		static const LED_Animation<2> Anim_Alternating;
-
-		static const AnimationBase & getAnimation(LED_Pattern pattern);
+		static const LED_Frame Frames[] PROGMEM;
+		static const LED_AnimationInfo Animations[] PROGMEM;
+		static const LED_AnimationSet Set PROGMEM;
+
+		// Frame table layout, index of the first frame for each animation
+		enum FrameIndex : uint8_t {
+			Frames_Off         = 0,
+			Frames_Blinking    = Frames_Off + 1,
+			Frames_BlinkSlow   = Frames_Blinking + 2,  // Shared by BlinkOnce
+			Frames_Flash1      = Frames_BlinkSlow + 2,
+			Frames_Flash2      = Frames_Flash1 + 2,
+			Frames_Flash3      = Frames_Flash2 + 2,
+			Frames_Flash4      = Frames_Flash3 + 2,
+			Frames_Player1     = Frames_Flash4 + 2,
+			Frames_Player2     = Frames_Player1 + 1,
+			Frames_Player3     = Frames_Player2 + 1,
+			Frames_Player4     = Frames_Player3 + 1,
+			Frames_Rotating    = Frames_Player4 + 1,
+			Frames_Alternating = Frames_Rotating + 4,
+			Frames_End         = Frames_Alternating + 2,
+		};
 
 	protected:
 		static constexpr uint32_t BlinkTime = 300;
@@ -202,58 +232,305 @@ namespace Xbox360Controller_LEDs {
 		static constexpr uint8_t States_Op2 = 0b0101;
 	};
 
+#ifdef XBOX_LED_STATS
+	struct LED_Stats {
+		unsigned long runs = 0;            // Calls to 'run()'
+		unsigned long frames = 0;          // Frames advanced
+		unsigned long writes = 0;          // Writes to the output
+		unsigned long patternChanges = 0;  // Patterns started
+		unsigned long linkedChanges = 0;   // Patterns started by the end of a linked animation
+		unsigned long ignoredLinks = 0;    // 'linkPattern' calls that didn't change the pattern
+
+		// Time from a frame's deadline until it was advanced, in the
+		// handler's timebase (ms unless using micros)
+		unsigned long lateFrames = 0;      // Frames advanced after their deadline
+		unsigned long latenessMax = 0;
+		unsigned long latenessTotal = 0;
+
+		unsigned long latenessMean() const {  // Over all frames advanced
+			return frames != 0 ? latenessTotal / frames : 0;
+		}
+	};
+#endif
+
+	// How 'run()' handles frames that are serviced late
+	enum class LED_Timing : uint8_t {
+		Serviced,  // Each frame starts when it's serviced (default). Lateness adds up over time.
+		CatchUp,   // Each frame starts at its deadline. Frames that are late are shown briefly, one per run.
+		Skip,      // Each frame starts at its deadline. Frames that are late are skipped over.
+	};
+
 	// --------------------------------------------------------
 	// LED Animation Handler                                  |
 	//     Handles frame parsing and animation timing         |
 	// --------------------------------------------------------
 
-	class XboxLEDHandler {
+	class XboxLEDHandlerCore {
 	public:
 		static const uint8_t NumPatterns = (uint8_t) LED_Pattern::NumPatterns;
-		using Animation = AnimationBase;
+		using Animation = LED_AnimationInfo;
 
-		XboxLEDHandler();
+		static const unsigned long NoDeadline = (unsigned long) -1;  // Returned if the frame never changes
 
-		virtual void begin() = 0;
+		LED_Pattern getPattern() const;
+		uint8_t getLastFrame() const;
 
-		void setPattern(LED_Pattern pattern);
-		void linkPattern(LED_Pattern pattern);
+		uint8_t getFrameIndex() const {  // Frame within the current animation
+			return frameIndex;
+		}
 
-		LED_Pattern getPattern() const;
+		uint8_t getCycleCount() const {  // Full cycles of the current animation
+			return cycleCount;
+		}
 
-		uint8_t getLastFrame() const;
-		void rewriteFrame();
-		
-		void pauseOutput();
-		void resumeOutput();
+		// Timing policy for 'run()', and the clock to use: millis() by
+		// default, or micros() for sub-millisecond precision
+		void setTiming(LED_Timing policy, boolean precise = false);
 
-		void run();
+		unsigned long getTime() const {  // Current time in the handler's timebase
+			return useMicros ? micros() : millis();
+		}
+
+		boolean usesMicros() const {
+			return useMicros;
+		}
+
+		// Scheduling, for firmware that sleeps between frames. Times are
+		// in the handler's timebase (see above).
+		unsigned long nextDeadline() const;  // Timestamp of the next frame change
+		unsigned long timeToNextFrame(unsigned long now) const;  // ms until the next frame change, 0 if due
+
+		// millis() and micros() are 32-bit and roll over, so times are
+		// compared by their 32-bit difference rather than their values
+		static uint32_t elapsed(unsigned long now, unsigned long since) {
+			return (uint32_t) (now - since);
+		}
+
+		static boolean reached(unsigned long now, unsigned long deadline) {
+			return (int32_t) (uint32_t) (now - deadline) >= 0;
+		}
+
+		// Plays user animations as patterns 'First' and up, O(1) by ID
+		void setUserAnimations(const LED_UserAnimations * user) {
+			userAnimations = user;
+		}
+
+		boolean isUserPattern(LED_Pattern pattern) const {
+			const uint8_t id = (uint8_t) pattern - LED_UserAnimations::First;
+			return userAnimations != nullptr && id < userAnimations->Count;
+		}
+
+#ifdef XBOX_LED_STATS
+		LED_Stats getStats() const;  // Snapshot, safe to call while 'run' is in an interrupt (see XboxLED_InterruptLock)
+		void resetStats();
+#endif
+
+		boolean isAnimating() const {
+			// Multiple frames (or one that links to another pattern), and this one ends
+			return animates && frameTicks != 0;
+		}
+
+		boolean isInverted() const {  // Output is active low, for the output classes
+			return inverted;
+		}
 
 	protected:
-		virtual const Animation & getAnimation(LED_Pattern pattern) const = 0;
-		virtual void setLEDs(uint8_t ledStates) = 0;
+		// The set and both of its tables are stored in flash (PROGMEM)
+		XboxLEDHandlerCore(const LED_AnimationSet * set, boolean inv = false);
+
+		// The functions below return 'true' if the last frame
+		// should be written to the LEDs by the output class
+		boolean applyPattern(LED_Pattern pattern, boolean link);
+		boolean applyPattern(LED_Pattern pattern, boolean link, unsigned long timestamp);  // Starting at 'timestamp'
+		boolean advanceFrame(unsigned long now);  // Next frame if due, starting 'now'
+		boolean advanceTo(unsigned long now);  // All frames due by 'now', each starting on time
+		boolean advance(unsigned long now);  // Per the timing policy
+		boolean seekPattern(LED_Pattern pattern, unsigned long epoch, unsigned long now);  // Set (not linked) as if started at 'epoch'
+		boolean setOutput(boolean enable);
+
+		// Bitmap of the LEDs that differ from the last frame written to
+		// the output (all of them if that isn't known, or if 'force' is
+		// set), then records the current frame as written. Zero if the
+		// output is already up to date.
+		uint8_t takeOutputChanges(boolean force = false);
+
+#ifdef XBOX_LED_STATS
+		LED_Stats stats;
+#endif
+
+		boolean frameDue(unsigned long now) const {
+			if (!isAnimating()) return false;  // No processing necessary
+			return elapsed(now, time_frameLast) >= frameDuration();
+		}
+
+		unsigned long frameDuration() const {  // Length of the current frame, in the handler's timebase
+			return (unsigned long) frameTicks * (useMicros ? LED_Frame::Timescale * 1000UL : LED_Frame::Timescale);
+		}
 
 	private:
-		void setPattern(LED_Pattern pattern, boolean runNow);
-		void runFrame();
+		boolean setPattern(LED_Pattern pattern, boolean runNow, unsigned long timestamp);
+		boolean startPattern(LED_Pattern pattern, unsigned long timestamp);
+		void resolveLink(LED_Pattern next);  // 'next' from the current animation
+		LED_Pattern linkTarget(LED_Pattern next) const {  // Where the current animation goes when it ends
+			return next == LED_Pattern::Previous ? previousPattern : next;
+		}
+		boolean nextFrame(unsigned long timestamp);
+		void recordLateness(unsigned long now);
+		uint32_t frameDeadline() const {  // End of the current frame
+			return time_frameLast + frameDuration();
+		}
+		boolean runFrame(unsigned long timestamp);
+		uint16_t getFrameTicks(uint8_t index) const;  // Length of a frame in the current animation
+		const LED_Frame * getFrame(uint8_t index) const;  // Frame in the current animation (flash, or RAM if 'userFrames')
+		Animation getAnimation(LED_Pattern pattern) const;  // From flash, or RAM for user patterns
+		void setAnimates(const Animation & animation);
+
+		// Animation set for the # of LEDs (flash)
+		const LED_AnimationSet * const animationSet;
+		const LED_UserAnimations * userAnimations = nullptr;  // (RAM)
 
 		// LED Information
-		boolean linkPatterns = false;
-		boolean writeOutput = true;
 		uint8_t lastLEDFrame = 0x00;  // Bitmap of last LED states
+		uint8_t outputLEDs = 0x00;  // Bitmap of the LED states last written to the output
+
+		// Flags, packed into a couple of bytes (set in the constructor)
+		boolean linkPatterns : 1;
+		boolean writeOutput : 1;
+		boolean outputKnown : 1;  // 'false' until the first write, and while paused
+		boolean userFrames : 1;   // Current frames are in RAM rather than flash
+		boolean useMicros : 1;    // Timebase is micros() rather than millis()
+		uint8_t timing : 2;       // LED_Timing policy
+		boolean linkBlocked : 1;  // The current animation can't hand off to 'linkTarget'
+		boolean animates : 1;     // The current animation changes frames, see 'isAnimating()'
+		boolean inverted : 1;     // Output is active low (only used by the output classes)
 
 		// Pattern Information (Enum)
 		LED_Pattern currentPattern;
 		LED_Pattern previousPattern;
 
-		// Animation Information
-		const Animation * currentAnimation;
+		// Animation Information, the animation and its frames are looked up by 'currentPattern'
 		uint8_t frameIndex = 0;
 		uint8_t cycleCount = 0;
 
-		// Timestamps (ms)
-		unsigned long time_frameLast = 0;
-		unsigned long time_frameDuration = 0;
+		// Timing, in the handler's timebase
+		uint32_t time_frameLast = 0;  // Start of the current frame
+		uint16_t frameTicks = 0;  // Length of the current frame, in LED_Frame::Timescale units
+	};
+
+	class XboxLEDHandler : public XboxLEDHandlerCore {
+	public:
+		XboxLEDHandler(const LED_AnimationSet * set, boolean inv = false);
+
+		virtual void begin() = 0;
+
+		void setPattern(LED_Pattern pattern);
+		void linkPattern(LED_Pattern pattern);
+
+		void rewriteFrame();  // Writes every LED, even if unchanged
+		
+		void pauseOutput();
+		void resumeOutput();
+
+		void run();
+		void run(unsigned long now);
+
+	protected:
+		void writeFrame();  // Writes the frame if any LEDs changed
+
+		virtual void setLEDs(uint8_t ledStates) = 0;
+
+		// Called instead of 'setLEDs' for every write. 'changed' has a bit
+		// set for each LED that differs from the last write, so outputs
+		// that are slow to write can override this to skip the rest.
+		virtual void updateLEDs(uint8_t ledStates, uint8_t changed) {
+			(void) changed;
+			setLEDs(ledStates);
+		}
+	};
+
+	// --------------------------------------------------------
+	// Static LED Animation Handler                           |
+	//     Same as above, but the output class is resolved at |
+	//     compile time (CRTP) so there are no virtual calls  |
+	//     and the output writes can be inlined. The output   |
+	//     class derives from this and provides:              |
+	//         void begin()                                   |
+	//         void setLEDs(uint8_t ledStates)                |
+	//     and optionally, to write only the changed LEDs:    |
+	//         void updateLEDs(uint8_t ledStates,             |
+	//                         uint8_t changed)               |
+	// --------------------------------------------------------
+
+	template <class Output, uint8_t nleds>
+	class XboxLEDHandlerStatic : public XboxLEDHandlerCore {
+	public:
+		XboxLEDHandlerStatic(boolean inv = false) :
+			XboxLEDHandlerCore(&XboxLEDAnimations<nleds>::Set, inv)
+		{
+			static_assert(nleds == 1 || nleds == 4,
+				"Error: Must use animations for either 1 or 4 LEDs");
+		}
+
+		void setPattern(LED_Pattern pattern) {
+			if (applyPattern(pattern, false)) writeFrame();
+		}
+
+		void linkPattern(LED_Pattern pattern) {
+			if (applyPattern(pattern, true)) writeFrame();
+		}
+
+		void rewriteFrame() {  // Writes every LED, even if unchanged
+			XBOX_LED_COUNT(writes);
+			OutputAccess::update(static_cast<Output &>(*this), getLastFrame(), takeOutputChanges(true));
+		}
+
+		void pauseOutput() {
+			setOutput(false);
+		}
+
+		void resumeOutput() {
+			if (setOutput(true)) writeFrame();
+		}
+
+		void run() {
+			XBOX_LED_COUNT(runs);
+			if (isAnimating() && advance(getTime())) writeFrame();
+		}
+
+		void run(unsigned long now) {
+			XBOX_LED_COUNT(runs);
+			if (advanceTo(now)) writeFrame();
+		}
+
+		constexpr uint8_t getNumLEDs() const {
+			return nleds;
+		}
+
+	protected:
+		void writeFrame() {  // Writes the frame if any LEDs changed
+			const uint8_t changed = takeOutputChanges();
+			if (changed == 0) return;
+			XBOX_LED_COUNT(writes);
+			OutputAccess::update(static_cast<Output &>(*this), getLastFrame(), changed);
+		}
+
+		// Default for outputs that don't provide their own
+		void updateLEDs(uint8_t ledStates, uint8_t changed) {
+			(void) changed;
+			OutputAccess::write(static_cast<Output &>(*this), ledStates);
+		}
+
+	private:
+		// Allows calling a protected 'setLEDs' / 'updateLEDs' in the output class
+		struct OutputAccess : Output {
+			static void write(Output & out, uint8_t ledStates) {
+				(out.*(&OutputAccess::setLEDs))(ledStates);
+			}
+
+			static void update(Output & out, uint8_t ledStates, uint8_t changed) {
+				(out.*(&OutputAccess::updateLEDs))(ledStates, changed);
+			}
+		};
 	};
 
 	// --------------------------------------------------------
@@ -262,22 +539,39 @@ namespace Xbox360Controller_LEDs {
 	//     output states to hardware                          |
 	// --------------------------------------------------------
 
+	template <uint8_t ...pins>
+	struct XboxLED_PinList {
+		static const size_t NumLEDs = sizeof... (pins);  // # of pins = # of LEDs
+
+		static void begin(boolean inverted) {  // Initialize LED outputs
+			const uint8_t Pins[NumLEDs] = { pins... };
+			for (uint8_t i = 0; i < NumLEDs; i++) {
+				pinMode(Pins[i], OUTPUT);
+				digitalWrite(Pins[i], inverted);  // Set 'off' immediately
+			}
+		}
+
+		static void write(uint8_t ledStates, boolean inverted, uint8_t mask = 0xFF) {  // Only the pins in 'mask'
+			const uint8_t Pins[NumLEDs] = { pins... };
+			for (uint8_t i = 0; i < NumLEDs; i++) {
+				if (!(mask & (1 << i))) continue;
+				// Invert both variables and use != to get logical XOR
+				digitalWrite(Pins[i], !(ledStates & (1 << i)) != !inverted);
+			}
+		}
+	};
+
 	template <uint8_t ...pins>
 	class XboxLED_IndividualPins : public XboxLEDHandler {
 	public:
 		static const size_t NumLEDs = sizeof... (pins);  // # of pins = # of LEDs
 
 		XboxLED_IndividualPins(const bool inv = false) :
-			XboxLEDHandler(),
-			Pins{ pins... },
-			Inverted(inv)
+			XboxLEDHandler(&XboxLEDAnimations<NumLEDs>::Set, inv)
 		{}
 
 		void begin() {  // Initialize LED outputs
-			for (uint8_t i = 0; i < NumLEDs; i++) {
-				pinMode(Pins[i], OUTPUT);
-				digitalWrite(Pins[i], Inverted);  // Set 'off' immediately
-			}
+			XboxLED_PinList<pins...>::begin(this->isInverted());
 			setPattern(LED_Pattern::Off);
 		}
 
@@ -286,34 +580,177 @@ namespace Xbox360Controller_LEDs {
 		}
 
 	protected:
-		const Animation & getAnimation(LED_Pattern pattern) const {
-			return XboxLEDAnimations<NumLEDs>::getAnimation(pattern);
+		void setLEDs(uint8_t ledStates) {
+			XboxLED_PinList<pins...>::write(ledStates, this->isInverted());
 		}
 
+		void updateLEDs(uint8_t ledStates, uint8_t changed) {
+			XboxLED_PinList<pins...>::write(ledStates, this->isInverted(), changed);
+		}
+	};
+
+	template <uint8_t ...pins>
+	class XboxLED_StaticPins : public XboxLEDHandlerStatic<XboxLED_StaticPins<pins...>, sizeof... (pins)> {
+	public:
+		static const size_t NumLEDs = sizeof... (pins);  // # of pins = # of LEDs
+
+		XboxLED_StaticPins(const bool inv = false) :
+			XboxLEDHandlerStatic<XboxLED_StaticPins<pins...>, sizeof... (pins)>(inv)
+		{}
+
+		void begin() {  // Initialize LED outputs
+			XboxLED_PinList<pins...>::begin(this->isInverted());
+			this->setPattern(LED_Pattern::Off);
+		}
+
+	protected:
 		void setLEDs(uint8_t ledStates) {
+			XboxLED_PinList<pins...>::write(ledStates, this->isInverted());
+		}
+
+		void updateLEDs(uint8_t ledStates, uint8_t changed) {
+			XboxLED_PinList<pins...>::write(ledStates, this->isInverted(), changed);
+		}
+	};
+
+	// --------------------------------------------------------
+	// Direct Port Output                                     |
+	//     Writes the LED states straight to the pin output   |
+	//     registers instead of using digitalWrite. If all    |
+	//     of the pins are on the same port, every LED is     |
+	//     updated with a single write.                       |
+	//                                                        |
+	//     The Arduino pin mapping macros read from tables in |
+	//     flash, so the ports are resolved once in begin()   |
+	//     rather than at compile time. Only the port number  |
+	//     and bit of each pin are kept, to save RAM. Boards  |
+	//     without 8-bit port registers fall back to          |
+	//     digitalWrite.                                      |
+	// --------------------------------------------------------
+
+#if defined(__AVR__) || defined(ARDUINO_HOST)
+	#define XBOX_LED_DIRECT_PORTS
+#endif
+
+	// Disables interrupts for the lifetime of the object, restoring the
+	// previous state afterwards so it is safe to use within an ISR. Other
+	// cores can't save the state through the Arduino API, so there the lock
+	// always enables interrupts again: don't take it with them disabled.
+	class XboxLED_InterruptLock {
+#if defined(__AVR__)
+	public:
+		XboxLED_InterruptLock() : sreg(SREG) { cli(); }
+		~XboxLED_InterruptLock() { SREG = sreg; }
+	private:
+		const uint8_t sreg;
+#elif defined(__arm__)
+	public:
+		XboxLED_InterruptLock() {  // Cortex-M, the interrupt mask is in PRIMASK
+			__asm__ volatile ("mrs %0, primask" : "=r" (primask));
+			__asm__ volatile ("cpsid i" ::: "memory");
+		}
+		~XboxLED_InterruptLock() {
+			__asm__ volatile ("msr primask, %0" :: "r" (primask) : "memory");
+		}
+	private:
+		uint32_t primask;
+#elif defined(ARDUINO_HOST)
+	public:
+		XboxLED_InterruptLock() {}  // Nothing interrupts a host program
+		~XboxLED_InterruptLock() {}
+#else
+	public:
+		XboxLED_InterruptLock() { noInterrupts(); }
+		~XboxLED_InterruptLock() { interrupts(); }
+#endif
+	};
+
+	template <uint8_t ...pins>
+	class XboxLED_DirectPins : public XboxLEDHandlerStatic<XboxLED_DirectPins<pins...>, sizeof... (pins)> {
+	public:
+		static const size_t NumLEDs = sizeof... (pins);  // # of pins = # of LEDs
+
+		XboxLED_DirectPins(const bool inv = false) :
+			XboxLEDHandlerStatic<XboxLED_DirectPins<pins...>, sizeof... (pins)>(inv)
+		{}
+
+		void begin() {  // Initialize LED outputs
+			XboxLED_PinList<pins...>::begin(this->isInverted());
+
+#ifdef XBOX_LED_DIRECT_PORTS
+			const uint8_t Pins[NumLEDs] = { pins... };
 			for (uint8_t i = 0; i < NumLEDs; i++) {
-				// Invert both variables and use != to get logical XOR
-				digitalWrite(Pins[i], !(ledStates & (1 << i)) != !Inverted);
+				ports[i] = digitalPinToPort(Pins[i]);
+				masks[i] = digitalPinToBitMask(Pins[i]);
+			}
+
+			// Check if all of the pins share a port
+			sharedMask = 0x00;
+			for (uint8_t i = 0; i < NumLEDs; i++) {
+				if (ports[i] != ports[0]) {
+					sharedMask = 0x00;
+					break;
+				}
+				sharedMask |= masks[i];
+			}
+#endif
+			this->setPattern(LED_Pattern::Off);
+		}
+
+	protected:
+		void setLEDs(uint8_t ledStates) {
+#ifdef XBOX_LED_DIRECT_PORTS
+			if (sharedMask != 0x00) {
+				// Port bits for the LED states, worked out per write rather
+				// than kept in a lookup table to save RAM
+				uint8_t bits = 0x00;
+				for (uint8_t i = 0; i < NumLEDs; i++) {
+					// Invert both variables and use != to get logical XOR
+					if (!(ledStates & (1 << i)) != !this->isInverted()) bits |= masks[i];
+				}
+
+				volatile uint8_t * port = portOutputRegister(ports[0]);
+				XboxLED_InterruptLock lock;  // Port may also be written by an ISR
+				*port = (*port & ~sharedMask) | bits;
+			}
+			else {
+				// Pins split across ports, write each individually
+				for (uint8_t i = 0; i < NumLEDs; i++) {
+					volatile uint8_t * port = portOutputRegister(ports[i]);
+					XboxLED_InterruptLock lock;
+					if (!(ledStates & (1 << i)) != !this->isInverted()) *port |= masks[i];
+					else *port &= ~masks[i];
+				}
 			}
+#else
+			XboxLED_PinList<pins...>::write(ledStates, this->isInverted());
+#endif
 		}
 
-		// LED Information
-		const uint8_t Pins[NumLEDs];
-		const boolean Inverted = false;  // Flag for inverted output
+#ifdef XBOX_LED_DIRECT_PORTS
+		uint8_t ports[NumLEDs];  // Port of each pin (see portOutputRegister)
+		uint8_t masks[NumLEDs];  // Bit mask of each pin on its port
+		uint8_t sharedMask = 0x00;  // Bit mask of all pins if they share a port, 0 if not
+#endif
 	};
 
 	template <uint8_t nleds>
 	class XboxLED_CustomOutput : public XboxLEDHandler {
 	public:
-		constexpr uint8_t getNumLEDs() const {
-			return nleds;
-		}
-
-	protected:
-		const Animation & getAnimation(LED_Pattern pattern) const {
+		XboxLED_CustomOutput() :
+			XboxLEDHandler(&XboxLEDAnimations<nleds>::Set)
+		{
 			static_assert(nleds == 1 || nleds == 4,
 				"Error: Must use animations for either 1 or 4 LEDs");
-			return XboxLEDAnimations<nleds>::getAnimation(pattern);
+		}
+
+		// User animation set (flash), e.g. '&Set' from an XboxLEDAnimationSet
+		XboxLED_CustomOutput(const LED_AnimationSet * set) :
+			XboxLEDHandler(set)
+		{}
+
+		constexpr uint8_t getNumLEDs() const {
+			return nleds;
 		}
 	};
 
@@ -321,11 +758,25 @@ namespace Xbox360Controller_LEDs {
 
 // Library API
 using XboxLEDPattern = Xbox360Controller_LEDs::LED_Pattern;
+using XboxLEDTiming = Xbox360Controller_LEDs::LED_Timing;
+
+#ifdef XBOX_LED_STATS
+using XboxLEDStats = Xbox360Controller_LEDs::LED_Stats;
+#endif
 
 template<uint8_t ...pins>
 using XboxControllerLEDs = Xbox360Controller_LEDs::XboxLED_IndividualPins<pins...>;
 
+template<uint8_t ...pins>
+using XboxControllerLEDs_Static = Xbox360Controller_LEDs::XboxLED_StaticPins<pins...>;
+
+template<uint8_t ...pins>
+using XboxControllerLEDs_Direct = Xbox360Controller_LEDs::XboxLED_DirectPins<pins...>;
+
 template<uint8_t nleds>
 using XboxControllerLEDs_Custom = Xbox360Controller_LEDs::XboxLED_CustomOutput<nleds>;
 
+template<class Output, uint8_t nleds>
+using XboxControllerLEDs_CustomStatic = Xbox360Controller_LEDs::XboxLEDHandlerStatic<Output, nleds>;
+
 #endif
@@ -0,0 +1,224 @@
+/*
+ *  Project     Xbox 360 Controller LEDs Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/Xbox360ControllerLEDs
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef X360LEDBackground_h
+#define X360LEDBackground_h
+
+#include "X360ControllerLEDs.h"
+#include "X360LEDQueue.h"
+
+namespace Xbox360Controller_LEDs {
+
+	// --------------------------------------------------------
+	// Background Timers                                      |
+	//     One hardware timer per supported MCU, run in CTC   |
+	//     mode with a /1024 prescaler. The compare value is  |
+	//     set so the interrupt fires at the next frame       |
+	//     deadline rather than at a fixed rate. Waits longer |
+	//     than the timer can count (about 16 ms on TIMER2,   |
+	//     4 s on the 16-bit timers at 16 MHz) are split into |
+	//     several compares, and only the last one runs the   |
+	//     animation.                                         |
+	//                                                        |
+	//         Uno / Nano (ATmega328P / 168): TIMER2 (8-bit)  |
+	//         Leonardo / Micro (ATmega32U4): TIMER3          |
+	//         Mega (ATmega2560 / 1280):      TIMER5          |
+	//                                                        |
+	//     TIMER2 is also used by tone(), TIMER3 and TIMER5   |
+	//     by the Servo library.                              |
+	// --------------------------------------------------------
+
+#if defined(__AVR_ATmega328P__) || defined(__AVR_ATmega168__)
+	#define XBOX_LED_BACKGROUND_VECT TIMER2_COMPA_vect
+
+	struct XboxLED_BackgroundTimer {
+		static const uint16_t MaxTicks = 0xFF;
+
+		static void begin() {
+			TCCR2A = (1 << WGM21);  // CTC mode
+			TCCR2B = (1 << CS22) | (1 << CS21) | (1 << CS20);  // Prescaler 1024
+		}
+
+		static void end() {
+			TIMSK2 &= ~(1 << OCIE2A);
+		}
+
+		static void schedule(uint16_t ticks) {
+			TCNT2 = 0;
+			OCR2A = ticks - 1;
+			TIMSK2 |= (1 << OCIE2A);
+		}
+	};
+
+#elif defined(__AVR_ATmega32U4__)
+	#define XBOX_LED_BACKGROUND_VECT TIMER3_COMPA_vect
+
+	struct XboxLED_BackgroundTimer {
+		static const uint16_t MaxTicks = 0xFFFF;
+
+		static void begin() {
+			TCCR3A = 0;
+			TCCR3B = (1 << WGM32) | (1 << CS32) | (1 << CS30);  // CTC mode, prescaler 1024
+		}
+
+		static void end() {
+			TIMSK3 &= ~(1 << OCIE3A);
+		}
+
+		static void schedule(uint16_t ticks) {
+			TCNT3 = 0;
+			OCR3A = ticks - 1;
+			TIMSK3 |= (1 << OCIE3A);
+		}
+	};
+
+#elif defined(__AVR_ATmega2560__) || defined(__AVR_ATmega1280__)
+	#define XBOX_LED_BACKGROUND_VECT TIMER5_COMPA_vect
+
+	struct XboxLED_BackgroundTimer {
+		static const uint16_t MaxTicks = 0xFFFF;
+
+		static void begin() {
+			TCCR5A = 0;
+			TCCR5B = (1 << WGM52) | (1 << CS52) | (1 << CS50);  // CTC mode, prescaler 1024
+		}
+
+		static void end() {
+			TIMSK5 &= ~(1 << OCIE5A);
+		}
+
+		static void schedule(uint16_t ticks) {
+			TCNT5 = 0;
+			OCR5A = ticks - 1;
+			TIMSK5 |= (1 << OCIE5A);
+		}
+	};
+#endif
+
+#ifdef XBOX_LED_BACKGROUND_VECT
+
+	// --------------------------------------------------------
+	// Background Handler                                     |
+	//     Runs the animations from a timer interrupt, so     |
+	//     nothing needs to be called from loop(). Pattern    |
+	//     changes are queued and picked up by the interrupt, |
+	//     which is fired early when a new pattern arrives.   |
+	//                                                        |
+	//     The sketch must attach the object to the timer     |
+	//     interrupt with XBOX_LED_BACKGROUND(object).        |
+	// --------------------------------------------------------
+
+	template <class Handler, uint8_t size = 8>
+	class XboxLED_Background : public XboxLED_Queued<Handler, size> {
+	public:
+		using Queued = XboxLED_Queued<Handler, size>;
+		using Queued::Queued;
+
+		static const uint32_t TickTime = (1024UL * 1000000UL) / F_CPU;  // us per timer tick
+
+		void beginBackground() {
+			XboxLED_InterruptLock lock;
+			XboxLED_BackgroundTimer::begin();
+			remainingTicks = 0;
+			XboxLED_BackgroundTimer::schedule(1);  // Fire right away to set the first deadline
+			running = true;
+		}
+
+		void endBackground() {
+			XboxLED_InterruptLock lock;
+			XboxLED_BackgroundTimer::end();
+			running = false;
+		}
+
+		void setPattern(LED_Pattern pattern) {
+			Queued::queuePattern(pattern);
+			wake();
+		}
+
+		void linkPattern(LED_Pattern pattern) {
+			Queued::queueLinkPattern(pattern);
+			wake();
+		}
+
+		// Called from the timer interrupt
+		void serviceTimer() {
+			if (remainingTicks != 0) {  // Partway through a long wait
+				scheduleTicks(remainingTicks);
+				return;
+			}
+
+			Queued::processQueue();
+			Handler::run(Handler::getTime());
+
+			const unsigned long wait = Handler::timeToNextFrame(Handler::getTime());
+			if (wait == Handler::NoDeadline) {
+				XboxLED_BackgroundTimer::end();  // Nothing to do until the pattern changes
+				return;
+			}
+
+			// Round up so the interrupt never fires before the frame is due
+			const uint32_t waitMicros = Handler::usesMicros() ? wait : wait * 1000UL;
+			const uint32_t ticks = ((waitMicros != 0 ? waitMicros : 1) + TickTime - 1) / TickTime + 1;
+			scheduleTicks(ticks);
+		}
+
+	private:
+		volatile boolean running = false;
+		uint32_t remainingTicks = 0;  // Left to wait after the current compare (only changed with interrupts off)
+
+		// Software postscaler: counts as much of the wait as the timer can,
+		// and keeps the rest for the following interrupts
+		void scheduleTicks(uint32_t ticks) {
+			const uint16_t count = ticks < XboxLED_BackgroundTimer::MaxTicks ? ticks : XboxLED_BackgroundTimer::MaxTicks;
+			remainingTicks = ticks - count;
+			XboxLED_BackgroundTimer::schedule(count);
+		}
+
+		void wake() {
+			XboxLED_InterruptLock lock;
+			if (!running) return;
+			remainingTicks = 0;  // Cut any long wait short
+			XboxLED_BackgroundTimer::schedule(1);  // Fire on the next tick to process the queue
+		}
+	};
+
+#endif
+
+}  // End namespace
+
+#ifdef XBOX_LED_BACKGROUND_VECT
+
+// Library API
+template<class Handler, uint8_t size = 8>
+using XboxControllerLEDs_Background = Xbox360Controller_LEDs::XboxLED_Background<Handler, size>;
+
+#define XBOX_LED_BACKGROUND(leds) ISR(XBOX_LED_BACKGROUND_VECT) { (leds).serviceTimer(); }
+
+#else
+#error "Background mode is not supported on this board. Supported MCUs: ATmega328P/168 (Uno, Nano), ATmega32U4 (Leonardo, Micro), ATmega2560/1280 (Mega)"
+#endif
+
+#endif
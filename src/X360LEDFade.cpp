@@ -0,0 +1,46 @@
+/*
+ *  Project     Xbox 360 Controller LEDs Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/Xbox360ControllerLEDs
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include "X360LEDFade.h"
+
+namespace Xbox360Controller_LEDs {
+
+#define XBOX_LED_GAMMA_4(n)   XboxLEDGamma::compute(n), XboxLEDGamma::compute(n + 1), XboxLEDGamma::compute(n + 2), XboxLEDGamma::compute(n + 3)
+#define XBOX_LED_GAMMA_16(n)  XBOX_LED_GAMMA_4(n), XBOX_LED_GAMMA_4(n + 4), XBOX_LED_GAMMA_4(n + 8), XBOX_LED_GAMMA_4(n + 12)
+#define XBOX_LED_GAMMA_64(n)  XBOX_LED_GAMMA_16(n), XBOX_LED_GAMMA_16(n + 16), XBOX_LED_GAMMA_16(n + 32), XBOX_LED_GAMMA_16(n + 48)
+
+const uint8_t XboxLEDGamma::Table[256] PROGMEM = {
+	XBOX_LED_GAMMA_64(0), XBOX_LED_GAMMA_64(64), XBOX_LED_GAMMA_64(128), XBOX_LED_GAMMA_64(192)
+};
+
+#undef XBOX_LED_GAMMA_4
+#undef XBOX_LED_GAMMA_16
+#undef XBOX_LED_GAMMA_64
+
+static_assert(XboxLEDGamma::compute(0) == 0 && XboxLEDGamma::compute(255) == 255,
+	"Gamma table must map off to off and full to full");
+
+}  // End namespace
@@ -0,0 +1,270 @@
+/*
+ *  Project     Xbox 360 Controller LEDs Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/Xbox360ControllerLEDs
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef X360LEDFade_h
+#define X360LEDFade_h
+
+#include "X360ControllerLEDs.h"
+
+namespace Xbox360Controller_LEDs {
+
+	// --------------------------------------------------------
+	// Gamma Correction                                       |
+	//     Maps a perceived brightness level (0 - 255) to a   |
+	//     PWM duty cycle using the CIE 1931 lightness curve. |
+	//     The table is computed at compile time and stored   |
+	//     in flash.                                          |
+	// --------------------------------------------------------
+
+	struct XboxLEDGamma {
+		static const uint8_t Table[256] PROGMEM;
+
+		static uint8_t correct(uint8_t level) {
+			return pgm_read_byte(&Table[level]);
+		}
+
+		// Lightness L = level * 100 / 255. Integer only, for use at compile time.
+		static constexpr uint8_t compute(uint8_t level) {
+			return (level * 100UL <= 8 * 255UL) ?
+				(uint8_t) ((level * 1000UL + 9033 / 2) / 9033) :  // Y = L / 903.3
+				(uint8_t) ((cube(level * 100ULL + 16 * 255ULL) * 255 + cube(116 * 255ULL) / 2) / cube(116 * 255ULL));  // Y = ((L + 16) / 116) ^ 3
+		}
+
+	private:
+		static constexpr unsigned long long cube(unsigned long long x) {
+			return x * x * x;
+		}
+	};
+
+	// --------------------------------------------------------
+	// Fade Kernel                                            |
+	//     Fixed-point blending between two brightness        |
+	//     levels. Fade progress is in 1/256ths (0 - 256).    |
+	// --------------------------------------------------------
+
+	enum class LED_Easing : uint8_t {
+		Step,    // No fade, change at the start of the frame
+		Linear,
+		Smooth,  // Ease in and out (smoothstep)
+	};
+
+	struct XboxLEDFadeKernel {
+		static const uint16_t Complete = 256;
+
+		// Fixed-point rate (8.8) for a fade of 'time' ms, so that progress
+		// can be calculated with a multiply instead of a divide
+		static uint16_t rate(uint16_t time) {
+			if (time == 0) return 0;
+			const uint32_t r = 65536UL / time;
+			return r > 0xFFFF ? 0xFFFF : (uint16_t) r;
+		}
+
+		static uint16_t progress(unsigned long elapsed, uint16_t rate, LED_Easing easing) {
+			if (rate == 0 || easing == LED_Easing::Step) return Complete;
+			if (elapsed >= 0xFFFF) return Complete;
+
+			uint32_t p = ((uint32_t) elapsed * rate) >> 8;
+			if (p >= Complete) return Complete;
+
+			if (easing == LED_Easing::Smooth) {
+				p = (p * p * (3 * Complete - 2 * p)) >> 16;  // 3p^2 - 2p^3
+			}
+			return (uint16_t) p;
+		}
+
+		static uint8_t blend(uint8_t from, uint8_t to, uint16_t progress) {
+			return (uint8_t) ((from * (Complete - progress) + to * progress) >> 8);
+		}
+	};
+
+	// --------------------------------------------------------
+	// Fading LED Animation Handler                           |
+	//     Plays the same animations, but cross-fades each    |
+	//     LED between frames instead of switching it on and  |
+	//     off. Call 'run' often (every ~10 ms) for smooth    |
+	//     fades. Like the static handler, the output class   |
+	//     derives from this and provides:                    |
+	//         void begin()                                   |
+	//         void setLevels(const uint8_t * levels)         |
+	//                                                        |
+	//     'levels' holds one gamma corrected PWM duty cycle  |
+	//     (0 - 255) per LED.                                 |
+	// --------------------------------------------------------
+
+	template <class Output, uint8_t nleds>
+	class XboxLEDFadeHandler : public XboxLEDHandlerCore {
+	public:
+		static const uint16_t DefaultFadeTime = 40;  // ms
+
+		XboxLEDFadeHandler(boolean inv = false) :
+			XboxLEDHandlerCore(&XboxLEDAnimations<nleds>::Set, inv)
+		{
+			static_assert(nleds == 1 || nleds == 4,
+				"Error: Must use animations for either 1 or 4 LEDs");
+		}
+
+		void setFade(uint16_t time, LED_Easing ease = LED_Easing::Linear) {
+			fadeRate = XboxLEDFadeKernel::rate(time);
+			easing = ease;
+		}
+
+		void setPattern(LED_Pattern pattern) {
+			applyPattern(pattern, false);
+			update(millis());
+		}
+
+		void linkPattern(LED_Pattern pattern) {
+			applyPattern(pattern, true);
+			update(millis());
+		}
+
+		void rewriteFrame() {
+			uint8_t duty[nleds];
+			for (uint8_t i = 0; i < nleds; i++) {
+				duty[i] = XboxLEDGamma::correct(levels[i]);
+			}
+			OutputAccess::write(static_cast<Output &>(*this), duty);
+		}
+
+		void pauseOutput() {
+			setOutput(false);
+			outputEnabled = false;
+		}
+
+		void resumeOutput() {
+			setOutput(true);
+			outputEnabled = true;
+			rewriteFrame();
+		}
+
+		void run() {
+			if (isAnimating()) advance(getTime());
+			update(millis());
+		}
+
+		void run(unsigned long now) {
+			advanceTo(now);
+			update(usesMicros() ? millis() : now);  // Fades are timed in ms
+		}
+
+		uint8_t getLevel(uint8_t led) const {
+			return levels[led];  // Before gamma correction
+		}
+
+		boolean isFading() const {
+			return fading;
+		}
+
+		constexpr uint8_t getNumLEDs() const {
+			return nleds;
+		}
+
+	private:
+		void update(unsigned long now) {
+			const uint8_t frame = getLastFrame();
+			if (frame != target) {  // New frame, fade from the current levels
+				target = frame;
+				for (uint8_t i = 0; i < nleds; i++) fadeFrom[i] = levels[i];
+				time_fadeStart = now;
+				fading = true;
+			}
+			if (!fading) return;
+
+			const uint16_t progress = XboxLEDFadeKernel::progress(XboxLEDHandlerCore::elapsed(now, time_fadeStart), fadeRate, easing);
+			if (progress == XboxLEDFadeKernel::Complete) fading = false;
+
+			boolean changed = false;
+			for (uint8_t i = 0; i < nleds; i++) {
+				const uint8_t level = XboxLEDFadeKernel::blend(fadeFrom[i], (target & (1 << i)) ? 255 : 0, progress);
+				if (level != levels[i]) {
+					levels[i] = level;
+					changed = true;
+				}
+			}
+			if (changed && outputEnabled) rewriteFrame();
+		}
+
+		// Allows calling a protected 'setLevels' in the output class
+		struct OutputAccess : Output {
+			static void write(Output & out, const uint8_t * levels) {
+				(out.*(&OutputAccess::setLevels))(levels);
+			}
+		};
+
+		// Fade Settings
+		uint16_t fadeRate = XboxLEDFadeKernel::rate(DefaultFadeTime);
+		LED_Easing easing = LED_Easing::Linear;
+
+		// Fade State
+		boolean fading = false;
+		boolean outputEnabled = true;
+		uint8_t target = 0x00;  // LED bitmap being faded to
+		uint8_t fadeFrom[nleds] = {};
+		uint8_t levels[nleds] = {};
+		unsigned long time_fadeStart = 0;
+	};
+
+	// --------------------------------------------------------
+	// PWM Pin Output                                         |
+	//     Fading output using analogWrite. All pins must be  |
+	//     PWM capable.                                       |
+	// --------------------------------------------------------
+
+	template <uint8_t ...pins>
+	class XboxLED_PWMPins : public XboxLEDFadeHandler<XboxLED_PWMPins<pins...>, sizeof... (pins)> {
+	public:
+		static const size_t NumLEDs = sizeof... (pins);  // # of pins = # of LEDs
+
+		XboxLED_PWMPins(const bool inv = false) :
+			XboxLEDFadeHandler<XboxLED_PWMPins<pins...>, sizeof... (pins)>(inv)
+		{}
+
+		void begin() {  // Initialize LED outputs
+			XboxLED_PinList<pins...>::begin(this->isInverted());
+			this->setPattern(LED_Pattern::Off);
+		}
+
+	protected:
+		void setLevels(const uint8_t * levels) {
+			const uint8_t Pins[NumLEDs] = { pins... };
+			for (uint8_t i = 0; i < NumLEDs; i++) {
+				analogWrite(Pins[i], this->isInverted() ? 255 - levels[i] : levels[i]);
+			}
+		}
+	};
+
+}  // End namespace
+
+// Library API
+using XboxLEDEasing = Xbox360Controller_LEDs::LED_Easing;
+
+template<uint8_t ...pins>
+using XboxControllerLEDs_PWM = Xbox360Controller_LEDs::XboxLED_PWMPins<pins...>;
+
+template<class Output, uint8_t nleds>
+using XboxControllerLEDs_CustomFade = Xbox360Controller_LEDs::XboxLEDFadeHandler<Output, nleds>;
+
+#endif
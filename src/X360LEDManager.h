@@ -0,0 +1,234 @@
+/*
+ *  Project     Xbox 360 Controller LEDs Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/Xbox360ControllerLEDs
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef X360LEDManager_h
+#define X360LEDManager_h
+
+#include "X360ControllerLEDs.h"
+
+namespace Xbox360Controller_LEDs {
+
+	// --------------------------------------------------------
+	// Multi-Controller LED Manager                           |
+	//     Runs the animations for many controllers from one  |
+	//     object. The clock is read once per pass, and the   |
+	//     controllers are kept in a min-heap ordered by      |
+	//     their next frame deadline, so a pass only touches  |
+	//     the controllers that are due.                      |
+	//                                                        |
+	//     The output class derives from this (CRTP) and      |
+	//     provides:                                          |
+	//         void begin()                                   |
+	//         void setLEDs(uint8_t controller, uint8_t leds) |
+	// --------------------------------------------------------
+
+	template <class Output, uint8_t nleds, uint8_t count>
+	class XboxLEDManager {
+	public:
+		static const uint8_t NumControllers = count;
+		static const unsigned long NoDeadline = XboxLEDHandlerCore::NoDeadline;
+
+		XboxLEDManager() {
+			static_assert(nleds == 1 || nleds == 4,
+				"Error: Must use animations for either 1 or 4 LEDs");
+			static_assert(count > 0 && count < NotQueued,
+				"Error: Manager must have between 1 and 254 controllers");
+
+			for (uint8_t i = 0; i < count; i++) {
+				heapPos[i] = NotQueued;
+			}
+		}
+
+		void setPattern(uint8_t controller, LED_Pattern pattern) {
+			if (controller >= count) return;
+			if (channels[controller].applyPattern(pattern, false)) writeFrame(controller);
+			schedule(controller);
+		}
+
+		void linkPattern(uint8_t controller, LED_Pattern pattern) {
+			if (controller >= count) return;
+			if (channels[controller].applyPattern(pattern, true)) writeFrame(controller);
+			schedule(controller);
+		}
+
+		void setPatternAll(LED_Pattern pattern) {
+			for (uint8_t i = 0; i < count; i++) setPattern(i, pattern);
+		}
+
+		LED_Pattern getPattern(uint8_t controller) const {
+			if (controller >= count) return LED_Pattern::Null;
+			return channels[controller].getPattern();
+		}
+
+		uint8_t getLastFrame(uint8_t controller) const {
+			if (controller >= count) return 0x00;
+			return channels[controller].getLastFrame();
+		}
+
+		void rewriteFrame(uint8_t controller) {  // Writes the LEDs, even if unchanged
+			if (controller >= count) return;
+			channels[controller].takeOutputChanges(true);
+			OutputAccess::write(static_cast<Output &>(*this), controller, channels[controller].getLastFrame());
+		}
+
+		unsigned long nextDeadline() const {  // Earliest deadline of all controllers
+			if (heapSize == 0) return NoDeadline;
+			return deadlines[heap[0]];
+		}
+
+		void run() {
+			if (heapSize != 0) run(millis());  // One clock read per pass
+		}
+
+		void run(unsigned long now) {
+			while (heapSize != 0 && due(heap[0], now)) {
+				const uint8_t controller = heap[0];
+				const uint32_t deadline = deadlines[controller];
+				if (channels[controller].advanceTo(now)) writeFrame(controller);
+
+				// If the deadline didn't move, the animation ended on a link
+				// that can't start a new frame (e.g. a user animation that
+				// links to itself). It would still be due, so it holds its
+				// last frame until its pattern is changed.
+				if (channels[controller].isAnimating() && channels[controller].nextDeadline() == deadline) remove(heapPos[controller]);
+				else schedule(controller);
+			}
+		}
+
+		// Plays user animations (e.g. from an XboxLEDRegistry) on every controller
+		void setUserAnimations(const LED_UserAnimations * user) {
+			for (uint8_t i = 0; i < count; i++) channels[i].setUserAnimations(user);
+		}
+
+	private:
+		static const uint8_t NotQueued = 0xFF;  // Heap position for controllers without a deadline
+
+		// Exposes the handler core functions to the manager
+		struct Channel : public XboxLEDHandlerCore {
+			Channel() : XboxLEDHandlerCore(&XboxLEDAnimations<nleds>::Set) {}
+			using XboxLEDHandlerCore::applyPattern;
+			using XboxLEDHandlerCore::advanceTo;
+			using XboxLEDHandlerCore::takeOutputChanges;
+		};
+
+		// Allows calling a protected 'setLEDs' in the output class
+		struct OutputAccess : Output {
+			static void write(Output & out, uint8_t controller, uint8_t ledStates) {
+				(out.*(&OutputAccess::setLEDs))(controller, ledStates);
+			}
+		};
+
+		void writeFrame(uint8_t controller) {  // Skips the write if the LEDs are unchanged
+			if (channels[controller].takeOutputChanges() == 0) return;
+			OutputAccess::write(static_cast<Output &>(*this), controller, channels[controller].getLastFrame());
+		}
+
+		boolean due(uint8_t controller, unsigned long now) const {
+			return XboxLEDHandlerCore::reached(now, deadlines[controller]);
+		}
+
+		boolean earlier(uint8_t a, uint8_t b) const {  // Overflow safe, deadlines are close together
+			return !XboxLEDHandlerCore::reached(deadlines[a], deadlines[b]);
+		}
+
+		// Updates the controller's place in the heap after its deadline changed
+		void schedule(uint8_t controller) {
+			const Channel & channel = channels[controller];
+			uint8_t pos = heapPos[controller];
+
+			if (!channel.isAnimating()) {
+				if (pos != NotQueued) remove(pos);
+				return;
+			}
+
+			deadlines[controller] = channel.nextDeadline();
+
+			if (pos == NotQueued) {
+				pos = heapSize++;
+				place(controller, pos);
+			}
+			siftDown(siftUp(pos));
+		}
+
+		void remove(uint8_t pos) {
+			const uint8_t controller = heap[pos];
+			heapPos[controller] = NotQueued;
+			heapSize--;
+
+			if (pos != heapSize) {
+				place(heap[heapSize], pos);  // Fill the hole with the last entry
+				siftDown(siftUp(pos));
+			}
+		}
+
+		void place(uint8_t controller, uint8_t pos) {
+			heap[pos] = controller;
+			heapPos[controller] = pos;
+		}
+
+		uint8_t siftUp(uint8_t pos) {
+			const uint8_t controller = heap[pos];
+			while (pos > 0) {
+				const uint8_t parent = (pos - 1) / 2;
+				if (!earlier(controller, heap[parent])) break;
+				place(heap[parent], pos);
+				pos = parent;
+			}
+			place(controller, pos);
+			return pos;
+		}
+
+		void siftDown(uint8_t pos) {
+			const uint8_t controller = heap[pos];
+			while (true) {
+				uint16_t child = 2 * (uint16_t) pos + 1;
+				if (child >= heapSize) break;
+				if (child + 1 < heapSize && earlier(heap[child + 1], heap[child])) child++;
+				if (!earlier(heap[child], controller)) break;
+				place(heap[child], pos);
+				pos = child;
+			}
+			place(controller, pos);
+		}
+
+		// Per-controller animation state
+		Channel channels[count];
+
+		// Scheduling state, kept in separate arrays so a pass only reads
+		// the deadlines of the controllers it visits
+		uint32_t deadlines[count];  // Next frame timestamp (ms)
+		uint8_t heap[count];     // Controller indices, earliest deadline first
+		uint8_t heapPos[count];  // Index of each controller in the heap
+		uint8_t heapSize = 0;
+	};
+
+}  // End namespace
+
+// Library API
+template<class Output, uint8_t nleds, uint8_t count>
+using XboxControllerLEDs_Manager = Xbox360Controller_LEDs::XboxLEDManager<Output, nleds, count>;
+
+#endif
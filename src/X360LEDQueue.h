@@ -0,0 +1,163 @@
+/*
+ *  Project     Xbox 360 Controller LEDs Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/Xbox360ControllerLEDs
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef X360LEDQueue_h
+#define X360LEDQueue_h
+
+#include "X360ControllerLEDs.h"
+#include "X360LEDReport.h"
+
+namespace Xbox360Controller_LEDs {
+
+	// --------------------------------------------------------
+	// Pattern Command Queue                                  |
+	//     Single-producer, single-consumer ring buffer of    |
+	//     pattern commands. One context (e.g. a USB receive  |
+	//     interrupt) pushes and another pops, without either |
+	//     side disabling interrupts. The indices are single  |
+	//     bytes, so reads and writes of them are atomic even |
+	//     on 8-bit AVR.                                      |
+	// --------------------------------------------------------
+
+	template <uint8_t size>
+	class XboxLEDCommandQueue {
+	public:
+		static_assert(size >= 2 && size <= 128 && (size & (size - 1)) == 0,
+			"Error: Queue size must be a power of two, between 2 and 128");
+
+		static const uint8_t Capacity = size - 1;  // One slot is kept open to tell 'full' from 'empty'
+
+		// Producer side. Returns 'false' if the queue is full and the command was dropped.
+		boolean push(LED_Pattern pattern, boolean link) {
+			const uint8_t h = __atomic_load_n(&head, __ATOMIC_RELAXED);
+			const uint8_t next = (h + 1) & Mask;
+
+			if (next == __atomic_load_n(&tail, __ATOMIC_ACQUIRE)) {
+				dropped++;
+				return false;
+			}
+
+			buffer[h] = (uint8_t) pattern | (link ? LinkFlag : 0x00);
+			__atomic_store_n(&head, next, __ATOMIC_RELEASE);  // Publish after the data is written
+			return true;
+		}
+
+		// Consumer side. Returns 'false' if there are no commands waiting.
+		boolean pop(LED_Pattern & pattern, boolean & link) {
+			const uint8_t t = __atomic_load_n(&tail, __ATOMIC_RELAXED);
+			if (t == __atomic_load_n(&head, __ATOMIC_ACQUIRE)) return false;  // Empty
+
+			const uint8_t command = buffer[t];
+			__atomic_store_n(&tail, (uint8_t) ((t + 1) & Mask), __ATOMIC_RELEASE);  // Free the slot after reading
+
+			pattern = (LED_Pattern) (command & ~LinkFlag);
+			link = command & LinkFlag;
+			return true;
+		}
+
+		boolean isEmpty() const {
+			return __atomic_load_n(&tail, __ATOMIC_ACQUIRE) == __atomic_load_n(&head, __ATOMIC_ACQUIRE);
+		}
+
+		uint8_t getDropped() const {  // # of commands lost to a full queue, written by the producer
+			return dropped;
+		}
+
+	private:
+		static const uint8_t Mask = size - 1;
+		static const uint8_t LinkFlag = 0x80;  // Command uses 'linkPattern' semantics
+
+		uint8_t buffer[size];
+		uint8_t head = 0;  // Next slot to write, only changed by the producer
+		uint8_t tail = 0;  // Next slot to read, only changed by the consumer
+		volatile uint8_t dropped = 0;
+	};
+
+	// --------------------------------------------------------
+	// Queued Handler                                         |
+	//     Wraps any handler or output class so that pattern  |
+	//     changes can be queued from another context. The    |
+	//     queue is drained at the start of every run(), so   |
+	//     all changes to the animation state happen in the   |
+	//     same context as the animation itself and none are  |
+	//     lost if several arrive between two calls to run(). |
+	// --------------------------------------------------------
+
+	template <class Handler, uint8_t size = 8>
+	class XboxLED_Queued : public Handler {
+	public:
+		using Handler::Handler;
+
+		boolean queuePattern(LED_Pattern pattern) {
+			return commands.push(pattern, false);
+		}
+
+		boolean queueLinkPattern(LED_Pattern pattern) {
+			return commands.push(pattern, true);
+		}
+
+		// Raw XInput LED report, queued with 'linkPattern' semantics.
+		// Returns 'false' if the report is invalid or the queue is full.
+		boolean queueReport(const uint8_t * report, uint8_t length) {
+			const LED_Pattern pattern = LED_Report::decode(report, length);
+			if (pattern == LED_Pattern::Null) return false;
+			return commands.push(pattern, true);
+		}
+
+		uint8_t getDroppedCommands() const {
+			return commands.getDropped();
+		}
+
+		void processQueue() {
+			LED_Pattern pattern;
+			boolean link;
+			while (commands.pop(pattern, link)) {
+				if (link) this->linkPattern(pattern);
+				else this->setPattern(pattern);
+			}
+		}
+
+		void run() {
+			processQueue();
+			Handler::run();
+		}
+
+		void run(unsigned long now) {
+			processQueue();
+			Handler::run(now);
+		}
+
+	private:
+		XboxLEDCommandQueue<size> commands;
+	};
+
+}  // End namespace
+
+// Library API
+template<class Handler, uint8_t size = 8>
+using XboxControllerLEDs_Queued = Xbox360Controller_LEDs::XboxLED_Queued<Handler, size>;
+
+#endif
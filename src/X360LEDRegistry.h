@@ -0,0 +1,205 @@
+/*
+ *  Project     Xbox 360 Controller LEDs Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/Xbox360ControllerLEDs
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef X360LEDRegistry_h
+#define X360LEDRegistry_h
+
+#include "X360ControllerLEDs.h"
+
+#if defined(__AVR__)
+#include <avr/eeprom.h>
+#endif
+
+namespace Xbox360Controller_LEDs {
+
+	// --------------------------------------------------------
+	// User Animation Registry                                |
+	//     Holds extra animations in RAM, loaded at runtime   |
+	//     from a compact binary format, e.g. stored in       |
+	//     EEPROM or received over serial. No heap is used;   |
+	//     the space is set by the template arguments.        |
+	//                                                        |
+	//     Once attached to a handler with                    |
+	//     'setUserAnimations', animation 'n' is played with  |
+	//     pattern ID 0x40 + n (see XboxLEDUserPattern) and   |
+	//     links like the built-in patterns.                  |
+	//                                                        |
+	//     Format, one byte each:                             |
+	//         'X', # of animations                           |
+	//         For each animation:                            |
+	//             # of frames, # of cycles, next pattern ID  |
+	//             For each frame: LED states, ticks (10 ms)  |
+	//         Checksum, so all bytes sum to 0 (mod 256)      |
+	// --------------------------------------------------------
+
+	enum class LED_LoadResult : uint8_t {
+		Ok,
+		Truncated,     // Ran out of data
+		BadHeader,     // Not an animation blob
+		TooLarge,      // More animations or frames than the registry holds
+		BadAnimation,  // Animation with no frames, or an invalid link
+		BadChecksum,
+	};
+
+	// Reads a blob from a buffer in RAM
+	class XboxLED_BufferReader {
+	public:
+		XboxLED_BufferReader(const uint8_t * data, size_t length) :
+			data(data), length(length)
+		{}
+
+		int read() {
+			if (index >= length) return -1;
+			return data[index++];
+		}
+
+	private:
+		const uint8_t * const data;
+		const size_t length;
+		size_t index = 0;
+	};
+
+#if defined(__AVR__)
+	// Reads a blob from the AVR's internal EEPROM
+	class XboxLED_EEPROMReader {
+	public:
+		XboxLED_EEPROMReader(uint16_t address) :
+			address(address)
+		{}
+
+		int read() {
+			if (address > E2END) return -1;
+			return eeprom_read_byte((const uint8_t *) address++);
+		}
+
+	private:
+		uint16_t address;
+	};
+#endif
+
+	template <uint8_t maxAnimations, uint8_t maxFrames>
+	class XboxLED_Registry : public LED_UserAnimations {
+	public:
+		static_assert(maxAnimations >= 1 && maxAnimations <= LED_UserAnimations::Max,
+			"Error: Registry must hold between 1 and 64 animations");
+		static_assert(maxFrames >= 1, "Error: Registry must hold at least one frame");
+
+		static const uint8_t Magic = 'X';
+
+		XboxLED_Registry() :
+			LED_UserAnimations{ frames, animations, 0 }
+		{}
+
+		// Replaces all animations. On failure the registry is left empty.
+		// Don't load while a handler is playing a user animation.
+		LED_LoadResult load(const uint8_t * data, size_t length) {
+			XboxLED_BufferReader reader(data, length);
+			return load(reader);
+		}
+
+		// 'Reader' provides 'int read()', returning -1 at the end of the data
+		template <class Reader>
+		LED_LoadResult load(Reader & reader) {
+			Count = 0;  // Hide the animations until everything is checked
+			uint8_t sum = 0;
+
+			const int magic = readByte(reader, sum);
+			const int count = readByte(reader, sum);
+			if (count < 0) return LED_LoadResult::Truncated;
+			if (magic != Magic) return LED_LoadResult::BadHeader;
+			if (count > maxAnimations) return LED_LoadResult::TooLarge;
+
+			uint8_t offset = 0;
+			for (uint8_t i = 0; i < count; i++) {
+				const int nframes = readByte(reader, sum);
+				const int ncycles = readByte(reader, sum);
+				const int next = readByte(reader, sum);
+				if (next < 0) return LED_LoadResult::Truncated;
+				if (nframes == 0 || !validLink(ncycles, next, count)) return LED_LoadResult::BadAnimation;
+				if (nframes > maxFrames - offset) return LED_LoadResult::TooLarge;
+
+				animations[i] = LED_AnimationInfo(offset, nframes, ncycles, (LED_Pattern) next);
+
+				for (uint8_t f = 0; f < nframes; f++) {
+					const int leds = readByte(reader, sum);
+					const int ticks = readByte(reader, sum);
+					if (ticks < 0) return LED_LoadResult::Truncated;
+					frames[offset++] = LED_Frame(leds, ticks * LED_Frame::Timescale);
+				}
+			}
+
+			if (readByte(reader, sum) < 0) return LED_LoadResult::Truncated;
+			if (sum != 0) return LED_LoadResult::BadChecksum;
+
+			Count = count;
+			return LED_LoadResult::Ok;
+		}
+
+		void clear() {
+			Count = 0;
+		}
+
+		uint8_t getNumAnimations() const {
+			return Count;
+		}
+
+	private:
+		template <class Reader>
+		static int readByte(Reader & reader, uint8_t & sum) {
+			const int b = reader.read();
+			if (b >= 0) sum += b;
+			return b;
+		}
+
+		static boolean validLink(uint8_t ncycles, uint8_t next, uint8_t count) {
+			if (ncycles == 0) return true;  // Runs forever, never links
+			if (next < (uint8_t) LED_Pattern::NumPatterns) return true;  // Built-in pattern
+			if (next == (uint8_t) LED_Pattern::Previous) return true;
+			return next >= LED_UserAnimations::First && next - LED_UserAnimations::First < count;
+		}
+
+		LED_Frame frames[maxFrames];
+		LED_AnimationInfo animations[maxAnimations];
+	};
+
+	constexpr LED_Pattern XboxLEDUserPattern(uint8_t n) {
+		return (LED_Pattern) (LED_UserAnimations::First + n);
+	}
+
+}  // End namespace
+
+// Library API
+template<uint8_t maxAnimations, uint8_t maxFrames>
+using XboxLEDRegistry = Xbox360Controller_LEDs::XboxLED_Registry<maxAnimations, maxFrames>;
+
+using XboxLEDLoadResult = Xbox360Controller_LEDs::LED_LoadResult;
+using Xbox360Controller_LEDs::XboxLEDUserPattern;
+
+#if defined(__AVR__)
+using XboxLEDEEPROMReader = Xbox360Controller_LEDs::XboxLED_EEPROMReader;
+#endif
+
+#endif
@@ -0,0 +1,74 @@
+/*
+ *  Project     Xbox 360 Controller LEDs Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/Xbox360ControllerLEDs
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef X360LEDReport_h
+#define X360LEDReport_h
+
+#include "X360ControllerLEDs.h"
+
+namespace Xbox360Controller_LEDs {
+
+	// --------------------------------------------------------
+	// XInput LED Reports                                     |
+	//     The host sets the controller's LED pattern with a  |
+	//     3 byte output report: type (0x01), length (0x03),  |
+	//     and pattern. The report is read in place, straight |
+	//     from the USB receive buffer, and is cheap enough   |
+	//     to decode in the endpoint's interrupt.             |
+	// --------------------------------------------------------
+
+	struct LED_Report {
+		static const uint8_t Type = 0x01;
+		static const uint8_t Length = 0x03;
+
+		// Pattern in the report, or 'Null' if it isn't a valid LED report
+		static LED_Pattern decode(const uint8_t * report, uint8_t length) {
+			if (length < Length || report[0] != Type || report[1] != Length) return LED_Pattern::Null;
+			if (report[2] > (uint8_t) LED_Pattern::Max) return LED_Pattern::Null;
+			return (LED_Pattern) report[2];
+		}
+
+		// Applies the report with 'linkPattern', the same way the controller
+		// does. Returns 'false' if it isn't a valid LED report.
+		//
+		// This calls the handler directly, so from an interrupt it's only
+		// safe with a handler that runs in the background (see
+		// X360LEDBackground.h). Queued handlers have 'queueReport' instead.
+		template <class Handler>
+		static boolean link(Handler & leds, const uint8_t * report, uint8_t length) {
+			const LED_Pattern pattern = decode(report, length);
+			if (pattern == LED_Pattern::Null) return false;
+			leds.linkPattern(pattern);
+			return true;
+		}
+	};
+
+}  // End namespace
+
+// Library API
+using XboxLEDReport = Xbox360Controller_LEDs::LED_Report;
+
+#endif
@@ -0,0 +1,306 @@
+/*
+ *  Project     Xbox 360 Controller LEDs Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/Xbox360ControllerLEDs
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef X360LEDSequence_h
+#define X360LEDSequence_h
+
+#include "X360ControllerLEDs.h"
+
+namespace Xbox360Controller_LEDs {
+
+	// --------------------------------------------------------
+	// Animation Sequences                                    |
+	//     Build animations out of types at compile time, so  |
+	//     timing mistakes are caught by the compiler:        |
+	//                                                        |
+	//         LED_Hold<leds, ms>         One frame           |
+	//         LED_Repeat<n, parts...>    'parts' n times     |
+	//         LED_Sequence<parts...>     'parts' in order    |
+	//                                                        |
+	//     A hold of 0 ms lasts forever. Consecutive frames   |
+	//     with the same LEDs are merged into one frame       |
+	//     (run-length compression) when the table is built.  |
+	// --------------------------------------------------------
+
+	namespace Sequence {
+		// Flattened list of frames, each a 'Frame<leds, ticks>'
+		template <class... Frames>
+		struct List {
+			static const unsigned int NumFrames = sizeof... (Frames);
+		};
+
+		template <uint8_t leds, uint16_t ticks>
+		struct Frame {
+			static const uint8_t LEDs = leds;
+			static const uint16_t Ticks = ticks;
+		};
+
+		// Joins frame lists end to end
+		template <class... Lists>
+		struct Concat { using type = List<>; };
+
+		template <class... A>
+		struct Concat<List<A...>> { using type = List<A...>; };
+
+		template <class... A, class... B, class... Rest>
+		struct Concat<List<A...>, List<B...>, Rest...> {
+			using type = typename Concat<List<A..., B...>, Rest...>::type;
+		};
+
+		template <uint8_t count, class L>
+		struct Repeat {
+			using type = typename Concat<L, typename Repeat<count - 1, L>::type>::type;
+		};
+
+		template <class L>
+		struct Repeat<0, L> { using type = List<>; };
+
+		// Run-length compression. Merges 'Current' with the next frame
+		// if they have the same LEDs and the total still fits in a frame.
+		template <class A, class B>
+		struct Mergeable {
+			static const boolean value = A::LEDs == B::LEDs &&
+				(A::Ticks == 0 || B::Ticks == 0 || (unsigned long) A::Ticks + B::Ticks <= 0xFFFF);
+			static const uint16_t Ticks = (!value || A::Ticks == 0 || B::Ticks == 0) ? 0 : A::Ticks + B::Ticks;  // 0 = forever
+		};
+
+		template <class Current, class In, class Out>
+		struct Compress;
+
+		template <class Current, class... Out>
+		struct Compress<Current, List<>, List<Out...>> {
+			using type = List<Out..., Current>;
+		};
+
+		template <class Current, class Next, class... In, class... Out>
+		struct Compress<Current, List<Next, In...>, List<Out...>> {
+			using type = typename LED_Select<Mergeable<Current, Next>::value,
+				Compress<Frame<Current::LEDs, Mergeable<Current, Next>::Ticks>, List<In...>, List<Out...>>,
+				Compress<Next, List<In...>, List<Out..., Current>>
+			>::type::type;
+		};
+
+		template <class L>
+		struct Compressed;
+
+		template <class First, class... Rest>
+		struct Compressed<List<First, Rest...>> {
+			using type = typename Compress<First, List<Rest...>, List<>>::type;
+		};
+
+		// Flash table for a list of frames
+		template <class L>
+		struct Table;
+
+		template <class... F>
+		struct Table<List<F...>> {
+			static const LED_Frame Frames[sizeof... (F)] PROGMEM;
+		};
+
+		template <class... F>
+		const LED_Frame Table<List<F...>>::Frames[sizeof... (F)] PROGMEM = {
+			LED_Frame(F::LEDs, F::Ticks * LED_Frame::Timescale)...
+		};
+	}
+
+	template <uint8_t leds, unsigned long ms>
+	struct LED_Hold {
+		static_assert(ms % LED_Frame::Timescale == 0,
+			"Error: Frame duration must be a multiple of the timescale (10 ms)");
+		static_assert(ms / LED_Frame::Timescale <= 0xFFFF,
+			"Error: Frame duration is too long (max 655350 ms). Use more than one hold");
+
+		using Frames = Sequence::List<Sequence::Frame<leds, (uint16_t) (ms / LED_Frame::Timescale)>>;
+	};
+
+	template <class... Parts>
+	struct LED_Sequence {
+		using Frames = typename Sequence::Concat<typename Parts::Frames...>::type;
+	};
+
+	template <uint8_t count, class... Parts>
+	struct LED_Repeat {
+		static_assert(count > 0, "Error: Must repeat at least once");
+
+		using Frames = typename Sequence::Repeat<count, typename LED_Sequence<Parts...>::Frames>::type;
+	};
+
+	// --------------------------------------------------------
+	// Animation Definition                                   |
+	//     A sequence that runs 'ncycles' times (0 = forever) |
+	//     before moving to the 'next' pattern when linked,   |
+	//     the same as the built-in animations.               |
+	// --------------------------------------------------------
+
+	template <class Seq, uint8_t ncycles = 0, LED_Pattern next = LED_Pattern::Null>
+	struct LED_SequenceAnimation {
+		static_assert(Seq::Frames::NumFrames > 0, "Error: Animation has no frames");
+
+		using Frames = typename Sequence::Compressed<typename Seq::Frames>::type;
+		static_assert(Frames::NumFrames <= 0xFF,
+			"Error: Animation has too many frames (max 255 after compression)");
+
+		static const unsigned int NumFrames = Frames::NumFrames;
+		static const uint8_t NCycles = ncycles;
+		static const LED_Pattern Next = next;
+	};
+
+	// --------------------------------------------------------
+	// Animation Set                                          |
+	//     One animation per pattern (in pattern order),      |
+	//     stored in flash as a single frame table and an     |
+	//     animation table, like the built-in sets. Patterns  |
+	//     with identical frames share them. Pass '&Set' to   |
+	//     a custom output.                                   |
+	// --------------------------------------------------------
+
+	namespace Sequence {
+		template <class Anim, unsigned int offset>
+		struct Placed {
+			using Frames = typename Anim::Frames;
+			static const unsigned int Offset = offset;
+
+			static constexpr LED_AnimationInfo info() {
+				return LED_AnimationInfo(offset, Anim::NumFrames, Anim::NCycles, Anim::Next);
+			}
+		};
+
+		template <class A, class B>
+		struct Same { static const boolean value = false; };
+
+		template <class A>
+		struct Same<A, A> { static const boolean value = true; };
+
+		// Finds an animation that was already placed with the same frames
+		template <class Frames, class PlacedList>
+		struct Find {
+			static const boolean found = false;
+			static const unsigned int Offset = 0;
+		};
+
+		template <class Frames, class First, class... Rest>
+		struct Find<Frames, List<First, Rest...>> :
+			LED_Select<Same<Frames, typename First::Frames>::value, Find<Frames, List<First>>, Find<Frames, List<Rest...>>>::type
+		{};
+
+		template <class Frames, class Only>
+		struct Find<Frames, List<Only>> {
+			static const boolean found = Same<Frames, typename Only::Frames>::value;
+			static const unsigned int Offset = Only::Offset;
+		};
+
+		// Assigns each animation its offset in the combined frame table.
+		// Animations with the same frames share them.
+		template <unsigned int offset, class PlacedList, class FrameList, class... Anims>
+		struct Place {
+			static const unsigned int NumFrames = offset;
+			using type = PlacedList;
+			using Frames = FrameList;
+		};
+
+		template <unsigned int offset, class... Done, class FrameList, class Anim, class... Rest>
+		struct Place<offset, List<Done...>, FrameList, Anim, Rest...> {
+			using Prior = Find<typename Anim::Frames, List<Done...>>;
+			using Next = typename LED_Select<Prior::found,
+				Place<offset, List<Done..., Placed<Anim, Prior::Offset>>, FrameList, Rest...>,
+				Place<offset + Anim::NumFrames, List<Done..., Placed<Anim, offset>>,
+					typename Concat<FrameList, typename Anim::Frames>::type, Rest...>
+			>::type;
+
+			static const unsigned int NumFrames = Next::NumFrames;
+			using type = typename Next::type;
+			using Frames = typename Next::Frames;
+		};
+
+		template <class PlacedList>
+		struct InfoTable;
+
+		template <class... P>
+		struct InfoTable<List<P...>> {
+			static const LED_AnimationInfo Animations[sizeof... (P)] PROGMEM;
+		};
+
+		template <class... P>
+		const LED_AnimationInfo InfoTable<List<P...>>::Animations[sizeof... (P)] PROGMEM = {
+			P::info()...
+		};
+
+		// Checks that no frame lights an LED outside of 'mask'
+		template <uint8_t mask, class L>
+		struct FitsLEDs { static const boolean value = true; };
+
+		template <uint8_t mask, class First, class... Rest>
+		struct FitsLEDs<mask, List<First, Rest...>> {
+			static const boolean value = (First::LEDs & ~mask) == 0 && FitsLEDs<mask, List<Rest...>>::value;
+		};
+	}
+
+	template <uint8_t nleds, class... Anims>
+	class XboxLEDAnimationSet {
+	private:
+		using Layout = Sequence::Place<0, Sequence::List<>, Sequence::List<>, Anims...>;
+		using AllFrames = typename Layout::Frames;
+
+	public:
+		static_assert(sizeof... (Anims) == (uint8_t) LED_Pattern::NumPatterns,
+			"Error: Animation set must have one animation for each pattern");
+		static_assert(Layout::NumFrames <= 0xFF,
+			"Error: Animation set has too many frames (max 255)");
+		static_assert(nleds >= 1 && nleds <= 8,
+			"Error: Animation set must be for 1 - 8 LEDs");
+		static_assert(Sequence::FitsLEDs<(uint8_t) ((1 << nleds) - 1), AllFrames>::value,
+			"Error: Frame uses more LEDs than the animation set has");
+
+		static const uint8_t NumLEDs = nleds;
+		static const unsigned int NumFrames = Layout::NumFrames;
+
+		static constexpr const LED_Frame * Frames = Sequence::Table<AllFrames>::Frames;
+		static constexpr const LED_AnimationInfo * Animations = Sequence::InfoTable<typename Layout::type>::Animations;
+		static const LED_AnimationSet Set PROGMEM;
+	};
+
+	template <uint8_t nleds, class... Anims>
+	const LED_AnimationSet XboxLEDAnimationSet<nleds, Anims...>::Set PROGMEM = { Frames, Animations };
+
+}  // End namespace
+
+// Library API
+template<uint8_t leds, unsigned long ms>
+using XboxLEDHold = Xbox360Controller_LEDs::LED_Hold<leds, ms>;
+
+template<class... Parts>
+using XboxLEDSequence = Xbox360Controller_LEDs::LED_Sequence<Parts...>;
+
+template<uint8_t count, class... Parts>
+using XboxLEDRepeat = Xbox360Controller_LEDs::LED_Repeat<count, Parts...>;
+
+template<class Seq, uint8_t ncycles = 0, XboxLEDPattern next = XboxLEDPattern::Null>
+using XboxLEDAnimation = Xbox360Controller_LEDs::LED_SequenceAnimation<Seq, ncycles, next>;
+
+template<uint8_t nleds, class... Anims>
+using XboxLEDAnimationSet = Xbox360Controller_LEDs::XboxLEDAnimationSet<nleds, Anims...>;
+
+#endif
@@ -0,0 +1,199 @@
+/*
+ *  Project     Xbox 360 Controller LEDs Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/Xbox360ControllerLEDs
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef X360LEDShiftRegister_h
+#define X360LEDShiftRegister_h
+
+#include "X360ControllerLEDs.h"
+#include "X360LEDManager.h"
+
+#include <SPI.h>
+
+namespace Xbox360Controller_LEDs {
+
+	// --------------------------------------------------------
+	// Shift Register Buses                                   |
+	//     Send a buffer to a chain of shift registers        |
+	//     (e.g. 74HC595). The last byte is sent first, so    |
+	//     the first byte ends up in the first register in    |
+	//     the chain.                                         |
+	// --------------------------------------------------------
+
+	// Hardware SPI: MOSI to the data input, SCK to the clock
+	template <uint32_t clockSpeed = 4000000>
+	struct XboxLED_SPIBus {
+		static void begin() {
+			SPI.begin();
+		}
+
+		static void transfer(const uint8_t * data, uint8_t size) {
+			SPI.beginTransaction(SPISettings(clockSpeed, MSBFIRST, SPI_MODE0));
+			for (uint8_t i = size; i > 0; i--) {
+				SPI.transfer(data[i - 1]);
+			}
+			SPI.endTransaction();
+		}
+	};
+
+	// Software 'shiftOut' on any two pins
+	template <uint8_t dataPin, uint8_t clockPin>
+	struct XboxLED_ShiftOutBus {
+		static void begin() {
+			pinMode(dataPin, OUTPUT);
+			pinMode(clockPin, OUTPUT);
+			digitalWrite(clockPin, LOW);
+		}
+
+		static void transfer(const uint8_t * data, uint8_t size) {
+			for (uint8_t i = size; i > 0; i--) {
+				shiftOut(dataPin, clockPin, MSBFIRST, data[i - 1]);
+			}
+		}
+	};
+
+	// --------------------------------------------------------
+	// Shift Register Frame Buffer                            |
+	//     Collects the packed LED states of many handlers    |
+	//     and sends them all in a single transfer. Writes    |
+	//     that don't change any bits don't mark the buffer   |
+	//     as dirty, and flush() does nothing unless it is.   |
+	//     (Daisy-chained registers have to be sent as a      |
+	//     whole, so a flush always sends every byte.)        |
+	// --------------------------------------------------------
+
+	template <uint8_t size, uint8_t latchPin, class Bus = XboxLED_SPIBus<>>
+	class XboxLED_ShiftBuffer {
+	public:
+		static const uint8_t Size = size;  // # of bytes (registers) in the chain
+
+		void begin() {
+			pinMode(latchPin, OUTPUT);
+			digitalWrite(latchPin, LOW);
+			Bus::begin();
+			dirty = true;  // Clear whatever is in the registers
+			flush();
+		}
+
+		// Writes 'nbits' LED states (up to 8), starting at bit 'offset' of the chain
+		void write(uint16_t offset, uint8_t nbits, uint8_t ledStates) {
+			for (uint8_t i = 0; i < nbits; i++, offset++) {
+				if ((offset >> 3) >= size) return;  // Out of range
+
+				uint8_t & data = buffer[offset >> 3];
+				const uint8_t mask = 1 << (offset & 0x07);
+				const uint8_t bit = (ledStates & (1 << i)) ? mask : 0x00;
+
+				if ((data & mask) != bit) {
+					data ^= mask;
+					dirty = true;
+				}
+			}
+		}
+
+		boolean isDirty() const {
+			return dirty;
+		}
+
+		void flush() {
+			if (!dirty) return;
+			Bus::transfer(buffer, size);
+			digitalWrite(latchPin, HIGH);  // Rising edge copies the shifted data to the outputs
+			digitalWrite(latchPin, LOW);
+			dirty = false;
+		}
+
+		const uint8_t * getBuffer() const {
+			return buffer;
+		}
+
+	private:
+		uint8_t buffer[size] = {};
+		boolean dirty = false;
+	};
+
+	// --------------------------------------------------------
+	// Shift Register Output                                  |
+	//     Multi-controller manager writing to a chain of     |
+	//     shift registers. Each controller uses 'nleds'      |
+	//     consecutive outputs, starting with the first       |
+	//     output of the first register. Pattern changes are  |
+	//     buffered and sent on the next call to run().       |
+	// --------------------------------------------------------
+
+	template <uint8_t nleds, uint8_t count, uint8_t latchPin, class Bus = XboxLED_SPIBus<>>
+	class XboxLED_ShiftRegisters
+		: public XboxLEDManager<XboxLED_ShiftRegisters<nleds, count, latchPin, Bus>, nleds, count>
+	{
+	public:
+		using Manager = XboxLEDManager<XboxLED_ShiftRegisters<nleds, count, latchPin, Bus>, nleds, count>;
+		static const uint8_t NumRegisters = ((uint16_t) nleds * count + 7) / 8;
+
+		XboxLED_ShiftRegisters(const bool inv = false) :
+			Inverted(inv)
+		{}
+
+		void begin() {
+			Manager::setPatternAll(LED_Pattern::Off);  // Into the buffer first, inverted outputs aren't all zeros
+			shiftBuffer.begin();  // Sends it, the only transfer
+		}
+
+		void run() {
+			Manager::run();
+			shiftBuffer.flush();  // One transfer for every controller that changed
+		}
+
+		void run(unsigned long now) {
+			Manager::run(now);
+			shiftBuffer.flush();
+		}
+
+		void flush() {
+			shiftBuffer.flush();
+		}
+
+	protected:
+		void setLEDs(uint8_t controller, uint8_t ledStates) {
+			if (Inverted) ledStates = ~ledStates;
+			shiftBuffer.write((uint16_t) controller * nleds, nleds, ledStates);
+		}
+
+		const boolean Inverted = false;  // Flag for inverted output
+		XboxLED_ShiftBuffer<NumRegisters, latchPin, Bus> shiftBuffer;
+	};
+
+}  // End namespace
+
+// Library API
+template<uint8_t nleds, uint8_t count, uint8_t latchPin, class Bus = Xbox360Controller_LEDs::XboxLED_SPIBus<>>
+using XboxControllerLEDs_ShiftRegisters = Xbox360Controller_LEDs::XboxLED_ShiftRegisters<nleds, count, latchPin, Bus>;
+
+template<uint8_t size, uint8_t latchPin, class Bus = Xbox360Controller_LEDs::XboxLED_SPIBus<>>
+using XboxLEDShiftBuffer = Xbox360Controller_LEDs::XboxLED_ShiftBuffer<size, latchPin, Bus>;
+
+template<uint8_t dataPin, uint8_t clockPin>
+using XboxLEDShiftOutBus = Xbox360Controller_LEDs::XboxLED_ShiftOutBus<dataPin, clockPin>;
+
+#endif
@@ -0,0 +1,191 @@
+/*
+ *  Project     Xbox 360 Controller LEDs Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/Xbox360ControllerLEDs
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef X360LEDSnapshot_h
+#define X360LEDSnapshot_h
+
+#include "X360ControllerLEDs.h"
+
+namespace Xbox360Controller_LEDs {
+
+	// Return type of a handler's 'getLastFrame'
+	template <class F>
+	struct XboxLED_FrameType;
+
+	template <class C, class R>
+	struct XboxLED_FrameType<R (C::*)() const> { using type = R; };
+
+	// Handler state at one point in time. 'Word' is the type the
+	// handler's 'getLastFrame' returns (uint8_t, or wider for rings).
+	template <class Word = uint8_t>
+	struct LED_Snapshot {
+		LED_Pattern pattern = LED_Pattern::Null;
+		uint8_t frameIndex = 0;  // Frame within the current animation
+		uint8_t cycle = 0;       // Full cycles of the current animation
+		Word leds = 0;           // Bitmap of the LED states
+		boolean animating = false;  // 'false' if the frame never changes
+		unsigned long deadline = 0; // Timestamp of the next frame change, in the handler's timebase
+
+		unsigned long timeToNextFrame(unsigned long now) const {
+			if (!animating) return XboxLEDHandlerCore::NoDeadline;
+			if (XboxLEDHandlerCore::reached(now, deadline)) return 0;  // Due now
+			return XboxLEDHandlerCore::elapsed(deadline, now);
+		}
+	};
+
+	// --------------------------------------------------------
+	// Handler Snapshots                                      |
+	//     Wraps any handler so that its state can be read    |
+	//     from another context (a thread, or the main loop   |
+	//     while the animation runs in an interrupt) without  |
+	//     ever seeing half of an update.                     |
+	//                                                        |
+	//     After every change, the writer publishes a copy of |
+	//     the state under a sequence lock: the sequence is   |
+	//     odd while the copy is being written. Readers retry |
+	//     until they copy it between two matching, even      |
+	//     sequence numbers. The animation never waits on a   |
+	//     reader, and readers never disable interrupts.      |
+	//                                                        |
+	//     Changes must all come from one context, as usual.  |
+	// --------------------------------------------------------
+
+	template <class Handler>
+	class XboxLED_Snapshots : public Handler {
+	public:
+		using Word = typename XboxLED_FrameType<decltype(&Handler::getLastFrame)>::type;
+		using Snapshot = LED_Snapshot<Word>;
+
+		using Handler::Handler;
+
+		void begin() {
+			Handler::begin();
+			publish();
+		}
+
+		void setPattern(LED_Pattern pattern) {
+			Handler::setPattern(pattern);
+			publish();
+		}
+
+		void linkPattern(LED_Pattern pattern) {
+			Handler::linkPattern(pattern);
+			publish();
+		}
+
+		void setTiming(LED_Timing policy, boolean precise = false) {
+			Handler::setTiming(policy, precise);
+			publish();  // Restarting the frame moves the deadline
+		}
+
+		void run() {
+			const Position before = position();
+			Handler::run();
+			if (position() != before) publish();  // Only after a new frame
+		}
+
+		void run(unsigned long now) {
+			const Position before = position();
+			Handler::run(now);
+			if (position() != before) publish();
+		}
+
+		// Safe to call from any context, while any of the above run
+		Snapshot getSnapshot() const {
+			Snapshot snapshot;
+			Sequence before, after;
+			do {
+				before = __atomic_load_n(&sequence, __ATOMIC_ACQUIRE);
+				copy(reinterpret_cast<uint8_t *>(&snapshot), reinterpret_cast<const uint8_t *>(&published), sizeof(Snapshot));
+				after = __atomic_load_n(&sequence, __ATOMIC_ACQUIRE);  // Kept after the copy by its acquire loads
+			} while ((before & 1) || before != after);  // Written in the meantime, try again
+			return snapshot;
+		}
+
+	private:
+		// Wide enough that a stalled reader can't miss a full wrap. On AVR
+		// the reader is only ever interrupted by the writer (not run in
+		// parallel), and a single byte is the largest atomic load.
+#if defined(__AVR__)
+		using Sequence = uint8_t;
+#else
+		using Sequence = uint32_t;
+#endif
+
+		// Changes with every new frame, or a linked pattern that shares the last one's animation
+		struct Position {
+			LED_Pattern pattern;
+			uint8_t frameIndex;
+			unsigned long deadline;
+
+			boolean operator!=(const Position & other) const {
+				return pattern != other.pattern || frameIndex != other.frameIndex || deadline != other.deadline;
+			}
+		};
+
+		Position position() const {
+			return { this->getPattern(), this->getFrameIndex(), this->nextDeadline() };
+		}
+
+		void publish() {
+			Snapshot snapshot;
+			snapshot.pattern = this->getPattern();
+			snapshot.frameIndex = this->getFrameIndex();
+			snapshot.cycle = this->getCycleCount();
+			snapshot.leds = this->getLastFrame();
+			snapshot.animating = this->isAnimating();
+			snapshot.deadline = this->nextDeadline();
+
+			const Sequence s = __atomic_load_n(&sequence, __ATOMIC_RELAXED);
+			__atomic_store_n(&sequence, (Sequence) (s + 1), __ATOMIC_RELEASE);  // Odd, writing. Kept before the copy by its release stores
+			copy(reinterpret_cast<uint8_t *>(&published), reinterpret_cast<const uint8_t *>(&snapshot), sizeof(Snapshot));
+			__atomic_store_n(&sequence, (Sequence) (s + 2), __ATOMIC_RELEASE);  // Even, done
+		}
+
+		// Byte by byte, each an atomic access, so the copies can race safely.
+		// Acquire loads and release stores order the copy between the two
+		// sequence accesses on either side, without a standalone fence: a
+		// reader that sees any byte of a write also sees it marked odd.
+		static void copy(uint8_t * dest, const uint8_t * src, size_t n) {
+			for (size_t i = 0; i < n; i++) {
+				__atomic_store_n(&dest[i], __atomic_load_n(&src[i], __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+			}
+		}
+
+		Sequence sequence = 0;
+		Snapshot published;  // Only accessed through 'copy'
+	};
+
+}  // End namespace
+
+// Library API
+template<class Word = uint8_t>
+using XboxLEDSnapshot = Xbox360Controller_LEDs::LED_Snapshot<Word>;
+
+template<class Handler>
+using XboxControllerLEDs_Snapshots = Xbox360Controller_LEDs::XboxLED_Snapshots<Handler>;
+
+#endif
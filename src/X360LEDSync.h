@@ -0,0 +1,156 @@
+/*
+ *  Project     Xbox 360 Controller LEDs Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/Xbox360ControllerLEDs
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef X360LEDSync_h
+#define X360LEDSync_h
+
+#include "X360ControllerLEDs.h"
+
+namespace Xbox360Controller_LEDs {
+
+	// --------------------------------------------------------
+	// Synchronized Group                                     |
+	//     Plays one animation on several handlers in phase.  |
+	//     The group runs a single animation state, timed     |
+	//     from the epoch where the pattern started, and      |
+	//     writes each new frame to every member. The frame   |
+	//     timing is worked out once per group rather than    |
+	//     once per member.                                   |
+	//                                                        |
+	//     While attached, a member's own output is paused so |
+	//     only the group writes to it, and detaching resumes |
+	//     it. Members must use the same # of LEDs as the     |
+	//     group.                                             |
+	// --------------------------------------------------------
+
+	template <uint8_t nleds, uint8_t maxMembers>
+	class XboxLEDSyncGroup : public XboxLEDHandlerCore {
+	public:
+		XboxLEDSyncGroup() :
+			XboxLEDHandlerCore(&XboxLEDAnimations<nleds>::Set)
+		{
+			static_assert(nleds == 1 || nleds == 4,
+				"Error: Must use animations for either 1 or 4 LEDs");
+			static_assert(maxMembers > 0, "Error: Group must hold at least one member");
+		}
+
+		boolean attach(XboxLEDHandler & member) {
+			for (uint8_t i = 0; i < numMembers; i++) {
+				if (members[i] == &member) return true;  // Already attached
+			}
+			if (numMembers >= maxMembers) return false;  // Full
+
+			members[numMembers++] = &member;
+			member.pauseOutput();  // Its own frames aren't shown while attached
+			if (getPattern() != LED_Pattern::Null) MemberAccess::write(member, getLastFrame(), 0xFF);  // Join in phase
+			return true;
+		}
+
+		void detach(XboxLEDHandler & member) {
+			for (uint8_t i = 0; i < numMembers; i++) {
+				if (members[i] != &member) continue;
+				members[i] = members[--numMembers];  // Order doesn't matter
+				member.resumeOutput();  // Back to its own pattern
+				return;
+			}
+		}
+
+		uint8_t getNumMembers() const {
+			return numMembers;
+		}
+
+		// Broadcast to every member. With an 'epoch' the pattern's
+		// timeline starts there (a future epoch starts now), and the
+		// group jumps straight to the frame due at this point in the
+		// cycle, so groups (or boards) given the same epoch stay in
+		// phase. Setting the same pattern again re-phases it.
+		void setPattern(LED_Pattern pattern) {
+			if (applyPattern(pattern, false)) writeFrame();
+		}
+
+		void setPattern(LED_Pattern pattern, unsigned long epoch) {
+			if (seekPattern(pattern, epoch, getTime())) writeFrame();
+		}
+
+		void linkPattern(LED_Pattern pattern) {
+			if (applyPattern(pattern, true)) writeFrame();
+		}
+
+		void rewriteFrame() {  // Writes every LED, even if unchanged
+			writeMembers(takeOutputChanges(true));
+		}
+
+		void pauseOutput() {
+			setOutput(false);
+		}
+
+		void resumeOutput() {
+			if (setOutput(true)) writeFrame();
+		}
+
+		void run() {
+			if (isAnimating()) run(getTime());
+		}
+
+		void run(unsigned long now) {
+			if (advanceTo(now)) writeFrame();  // Frames always start on their deadlines
+		}
+
+		constexpr uint8_t getNumLEDs() const {
+			return nleds;
+		}
+
+	private:
+		// Allows calling the protected 'updateLEDs' in each member
+		struct MemberAccess : XboxLEDHandler {
+			static void write(XboxLEDHandler & member, uint8_t ledStates, uint8_t changed) {
+				(member.*(&MemberAccess::updateLEDs))(ledStates, changed);
+			}
+		};
+
+		void writeFrame() {  // Skips the members if the LEDs are unchanged
+			const uint8_t changed = takeOutputChanges();
+			if (changed != 0) writeMembers(changed);
+		}
+
+		void writeMembers(uint8_t changed) {
+			const uint8_t leds = getLastFrame();
+			for (uint8_t i = 0; i < numMembers; i++) {
+				MemberAccess::write(*members[i], leds, changed);
+			}
+		}
+
+		XboxLEDHandler * members[maxMembers];
+		uint8_t numMembers = 0;
+	};
+
+}  // End namespace
+
+// Library API
+template<uint8_t nleds, uint8_t maxMembers>
+using XboxControllerLEDs_SyncGroup = Xbox360Controller_LEDs::XboxLEDSyncGroup<nleds, maxMembers>;
+
+#endif
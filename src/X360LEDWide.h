@@ -0,0 +1,326 @@
+/*
+ *  Project     Xbox 360 Controller LEDs Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/Xbox360ControllerLEDs
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef X360LEDWide_h
+#define X360LEDWide_h
+
+#include "X360ControllerLEDs.h"
+
+namespace Xbox360Controller_LEDs {
+
+	// Smallest unsigned type with one bit per LED
+	template <uint8_t nleds>
+	struct XboxLEDFrameWord {
+		static_assert(nleds >= 1 && nleds <= 64,
+			"Error: Wide frames must have 1 - 64 LEDs");
+
+		using type =
+			typename LED_Select<(nleds <= 8), uint8_t,
+			typename LED_Select<(nleds <= 16), uint16_t,
+			typename LED_Select<(nleds <= 32), uint32_t,
+			uint64_t>::type>::type>::type;
+	};
+
+	namespace Wide {
+		template <uint8_t... I>
+		struct Indices {};
+
+		template <uint8_t n, uint8_t... I>
+		struct MakeIndices : MakeIndices<n - 1, n - 1, I...> {};
+
+		template <uint8_t... I>
+		struct MakeIndices<0, I...> { using type = Indices<I...>; };
+
+		// Flash table of 'Gen::get(i)' for every index
+		template <class Gen, class Idx = typename MakeIndices<Gen::Size>::type>
+		struct Table;
+
+		template <class Gen, uint8_t... I>
+		struct Table<Gen, Indices<I...>> {
+			static const typename Gen::Entry Data[sizeof... (I)] PROGMEM;
+		};
+
+		template <class Gen, uint8_t... I>
+		const typename Gen::Entry Table<Gen, Indices<I...>>::Data[sizeof... (I)] PROGMEM = {
+			Gen::get(I)...
+		};
+	}
+
+	// --------------------------------------------------------
+	// Wide Animation Lists                                   |
+	//     The 4 LED animations, scaled to a ring of 'nleds'  |
+	//     segments. Each player's quadrant covers a quarter  |
+	//     of the ring, and 'Rotating' steps a single segment |
+	//     around it in about the same 400 ms (at least one   |
+	//     10 ms tick per segment).                           |
+	//                                                        |
+	//     The frames are ordinary 'LED_Frame's, so the       |
+	//     handler core plays and links them as usual, but    |
+	//     their 'LEDs' byte is an index into the 'Words'     |
+	//     table: one flash read gets the state of every LED. |
+	//                                                        |
+	//     Bit 0 is the first segment of player 1's quadrant, |
+	//     and the rest follow clockwise (player 1, 2, 4, 3). |
+	// --------------------------------------------------------
+
+	template <uint8_t nleds>
+	class XboxLEDWideAnimations : protected XboxLEDAnimations<4> {
+	public:
+		static_assert(nleds >= 4 && nleds <= 64,
+			"Error: Wide animations must have 4 - 64 LEDs");
+
+		using Word = typename XboxLEDFrameWord<nleds>::type;
+
+		static const uint8_t NumLEDs = nleds;
+
+		// Frame table layout, as the 4 LED table with 'nleds' rotating frames
+		enum FrameIndex : uint8_t {
+			Frames_Off         = 0,
+			Frames_Blinking    = Frames_Off + 1,
+			Frames_BlinkSlow   = Frames_Blinking + 2,  // Shared by BlinkOnce
+			Frames_Flash1      = Frames_BlinkSlow + 2,  // Flash 1 - 4, two frames each
+			Frames_Player1     = Frames_Flash1 + 8,     // Player 1 - 4, one frame each
+			Frames_Rotating    = Frames_Player1 + 4,
+			Frames_Alternating = Frames_Rotating + nleds,
+			Frames_End         = Frames_Alternating + 2,
+		};
+
+		// Word table layout. The first 16 words are the 4 LED states
+		// scaled to the ring, so the 4 LED states work as indices.
+		static const uint8_t Words_Segment = 16;  // Single segments, for 'Rotating'
+		static const uint8_t NumWords = Words_Segment + nleds;
+
+		static constexpr Word AllLEDs = (Word) ((Word) ~(Word) 0 >> (sizeof(Word) * 8 - nleds));
+
+		static Word getWord(uint8_t index) {  // From flash
+			Word w;
+			memcpy_P(&w, &WordTable::Data[index], sizeof(Word));
+			return w;
+		}
+
+		struct FrameList {
+			using Entry = LED_Frame;
+			static const uint8_t Size = Frames_End;
+			static constexpr Entry get(uint8_t i) { return frame(i); }
+		};
+
+		struct WordList {
+			using Entry = Word;
+			static const uint8_t Size = NumWords;
+			static constexpr Entry get(uint8_t i) {
+				return i < Words_Segment ? scale(i) : (Word) ((Word) 1 << (i - Words_Segment));
+			}
+		};
+
+		using FrameTable = Wide::Table<FrameList>;
+		using WordTable = Wide::Table<WordList>;
+
+		static constexpr const LED_Frame * Frames = FrameTable::Data;
+		static const LED_AnimationInfo Animations[] PROGMEM;
+		static const LED_AnimationSet Set PROGMEM;
+
+	protected:
+		// One full rotation in the time the 4 LED pattern takes, at least one tick per step
+		static constexpr uint16_t RotateTicks =
+			(RotateTime * 4 / nleds) / LED_Frame::Timescale != 0 ?
+			(RotateTime * 4 / nleds) / LED_Frame::Timescale : 1;
+
+		static constexpr LED_Frame frame(uint8_t i) {
+			return
+				i == Frames_Off         ? LED_Frame(States_Off, 0) :
+				i == Frames_Blinking    ? LED_Frame(States_Off, BlinkTime) :
+				i <  Frames_BlinkSlow   ? LED_Frame(States_On,  BlinkTime) :
+				i == Frames_BlinkSlow   ? LED_Frame(States_Off, BlinkSlow) :
+				i <  Frames_Flash1      ? LED_Frame(States_On,  BlinkTime) :
+				i <  Frames_Player1     ? LED_Frame((i - Frames_Flash1) % 2 ? (1 << (i - Frames_Flash1) / 2) : States_Off, BlinkTime) :
+				i <  Frames_Rotating    ? LED_Frame(1 << (i - Frames_Player1), 0) :
+				i <  Frames_Alternating ? LED_Frame(Words_Segment + (i - Frames_Rotating), RotateTicks * LED_Frame::Timescale) :
+				i == Frames_Alternating ? LED_Frame(States_Op1, BlinkTime) :
+				                          LED_Frame(States_Op2, BlinkTime);
+		}
+
+		// Segments [first, last)
+		static constexpr Word span(uint8_t first, uint8_t last) {
+			return first >= last ? 0 : (Word) (((Word) 1 << first) | span(first + 1, last));
+		}
+
+		// Quadrants in ring order: player 1, 2, 4, 3
+		static constexpr Word quadrant(uint8_t q) {
+			return span(q * nleds / 4, (q + 1) * nleds / 4);
+		}
+
+		// 4 LED states to ring segments
+		static constexpr Word scale(uint8_t states) {
+			return (Word) (
+				((states & States_Player1) ? quadrant(0) : 0) |
+				((states & States_Player2) ? quadrant(1) : 0) |
+				((states & States_Player4) ? quadrant(2) : 0) |
+				((states & States_Player3) ? quadrant(3) : 0));
+		}
+	};
+
+	template <uint8_t nleds>
+	constexpr typename XboxLEDWideAnimations<nleds>::Word XboxLEDWideAnimations<nleds>::AllLEDs;
+
+	template <uint8_t nleds>
+	constexpr const LED_Frame * XboxLEDWideAnimations<nleds>::Frames;
+
+	// Indexed by pattern, as the 4 LED table
+	template <uint8_t nleds>
+	const LED_AnimationInfo XboxLEDWideAnimations<nleds>::Animations[] PROGMEM = {
+		LED_AnimationInfo(Frames_Off, 1),  // Off
+		LED_AnimationInfo(Frames_Blinking, 2, 4, LED_Pattern::BlinkSlow),  // Blink 4 times, then blink slow
+
+		LED_AnimationInfo(Frames_Flash1 + 0, 2, PlayerBlinkCount, LED_Pattern::Player1),  // Flash n times, then Player 1
+		LED_AnimationInfo(Frames_Flash1 + 2, 2, PlayerBlinkCount, LED_Pattern::Player2),  // Flash n times, then Player 2
+		LED_AnimationInfo(Frames_Flash1 + 4, 2, PlayerBlinkCount, LED_Pattern::Player3),  // Flash n times, then Player 3
+		LED_AnimationInfo(Frames_Flash1 + 6, 2, PlayerBlinkCount, LED_Pattern::Player4),  // Flash n times, then Player 4
+
+		LED_AnimationInfo(Frames_Player1 + 0, 1),  // Player 1
+		LED_AnimationInfo(Frames_Player1 + 1, 1),  // Player 2
+		LED_AnimationInfo(Frames_Player1 + 2, 1),  // Player 3
+		LED_AnimationInfo(Frames_Player1 + 3, 1),  // Player 4
+
+		LED_AnimationInfo(Frames_Rotating,    nleds, 50, LED_Pattern::Previous),  // Rotate 50 times, then go back
+		LED_AnimationInfo(Frames_BlinkSlow,   2,      1, LED_Pattern::Previous),  // BlinkOnce, then go back
+		LED_AnimationInfo(Frames_BlinkSlow,   2,     16, LED_Pattern::Previous),  // BlinkSlow 16 times, then go back
+		LED_AnimationInfo(Frames_Alternating, 2,      7, LED_Pattern::Previous),  // Alternate 7 times, then go back
+	};
+
+	template <uint8_t nleds>
+	const LED_AnimationSet XboxLEDWideAnimations<nleds>::Set PROGMEM = { Frames, Animations };
+
+	// --------------------------------------------------------
+	// Wide Output                                            |
+	//     Static output (see above) for more than 8 LEDs.    |
+	//     The output class derives from this and provides:   |
+	//         void begin()                                   |
+	//         void setLEDs(Word ledStates)                   |
+	//     and optionally, to write only the changed LEDs:    |
+	//         void updateLEDs(Word ledStates, Word changed)  |
+	//     where 'Word' is the smallest unsigned type with a  |
+	//     bit for every LED.                                 |
+	// --------------------------------------------------------
+
+	template <class Output, uint8_t nleds>
+	class XboxLEDWideHandler : public XboxLEDHandlerCore {
+	public:
+		using AnimationSet = XboxLEDWideAnimations<nleds>;
+		using Word = typename AnimationSet::Word;
+
+		XboxLEDWideHandler() :
+			XboxLEDHandlerCore(&AnimationSet::Set)
+		{}
+
+		void setPattern(LED_Pattern pattern) {
+			if (applyPattern(pattern, false)) writeFrame(false);
+		}
+
+		void linkPattern(LED_Pattern pattern) {
+			if (applyPattern(pattern, true)) writeFrame(false);
+		}
+
+		void rewriteFrame() {  // Writes every LED, even if unchanged
+			writeFrame(true);
+		}
+
+		void pauseOutput() {
+			setOutput(false);
+		}
+
+		void resumeOutput() {
+			if (setOutput(true)) writeFrame(false);
+		}
+
+		void run() {
+			XBOX_LED_COUNT(runs);
+			if (isAnimating() && advance(getTime())) writeFrame(false);
+		}
+
+		void run(unsigned long now) {
+			XBOX_LED_COUNT(runs);
+			if (advanceTo(now)) writeFrame(false);
+		}
+
+		Word getLastFrame() const {  // State of every LED
+			return AnimationSet::getWord(XboxLEDHandlerCore::getLastFrame());
+		}
+
+		// The user animations are 8 LED frames, not word table indices
+		void setUserAnimations(const LED_UserAnimations * user) = delete;
+
+		constexpr uint8_t getNumLEDs() const {
+			return nleds;
+		}
+
+	protected:
+		void writeFrame(boolean force) {
+			// The core tracks word table indices. Indices are below 0x80,
+			// so a difference of 0xFF means that every LED must be written.
+			const uint8_t index = XboxLEDHandlerCore::getLastFrame();
+			const uint8_t diff = takeOutputChanges(force);
+			if (diff == 0) return;
+
+			const Word ledStates = AnimationSet::getWord(index);
+			const Word changed = (diff == 0xFF) ? AnimationSet::AllLEDs :
+				(Word) (ledStates ^ AnimationSet::getWord(index ^ diff));
+			if (changed == 0) return;  // Different frame, same LEDs
+
+			XBOX_LED_COUNT(writes);
+			OutputAccess::update(static_cast<Output &>(*this), ledStates, changed);
+		}
+
+		// Default for outputs that don't provide their own
+		void updateLEDs(Word ledStates, Word changed) {
+			(void) changed;
+			OutputAccess::write(static_cast<Output &>(*this), ledStates);
+		}
+
+	private:
+		static_assert(AnimationSet::NumWords < 0x80, "Error: Word table indices must be below 0x80");
+
+		// Allows calling a protected 'setLEDs' / 'updateLEDs' in the output class
+		struct OutputAccess : Output {
+			static void write(Output & out, Word ledStates) {
+				(out.*(&OutputAccess::setLEDs))(ledStates);
+			}
+
+			static void update(Output & out, Word ledStates, Word changed) {
+				(out.*(&OutputAccess::updateLEDs))(ledStates, changed);
+			}
+		};
+	};
+
+}  // End namespace
+
+// Library API
+template<uint8_t nleds>
+using XboxLEDWideAnimations = Xbox360Controller_LEDs::XboxLEDWideAnimations<nleds>;
+
+template<class Output, uint8_t nleds>
+using XboxControllerLEDs_Wide = Xbox360Controller_LEDs::XboxLEDWideHandler<Output, nleds>;
+
+#endif